@@ -1,5 +1,6 @@
 import argparse
 import json
+import mmap
 import subprocess
 import sys
 from pathlib import Path
@@ -31,34 +32,58 @@ def update_overview() -> None:
 
     print(f"Overview: file://{overview_file.resolve()}")
 
-def run_input(solver: Path, input: Path, output_directory: Path) -> int:
+def convert_inputs(converter: Path, inputs: List[Path]) -> List[Path]:
+    binary_directory = Path(__file__).parent / "binary"
+    if not binary_directory.is_dir():
+        binary_directory.mkdir(parents=True)
+
+    binary_inputs = []
+    for input in inputs:
+        binary_input = binary_directory / f"{input.stem}.bin"
+
+        if not binary_input.is_file() or binary_input.stat().st_mtime < input.stat().st_mtime:
+            process = subprocess.run([str(converter), str(input), str(binary_input)])
+            if process.returncode != 0:
+                raise RuntimeError(f"Converter exited with status code {process.returncode} for input {input.stem}")
+
+        binary_inputs.append(binary_input)
+
+    return binary_inputs
+
+def run_input(solver: Path, input: Path, output_directory: Path, warm: bool, solver_arguments: List[str]) -> int:
     stdout_file = output_directory / f"{input.stem}.out"
     stderr_file = output_directory / f"{input.stem}.log"
 
+    arguments = [str(solver), *solver_arguments]
+    if warm and stdout_file.is_file():
+        previous_file = output_directory / f"{input.stem}.prev.out"
+        stdout_file.replace(previous_file)
+        arguments.append(f"--warm={previous_file}")
+
     with input.open("rb") as stdin, stdout_file.open("wb+") as stdout, stderr_file.open("wb+") as stderr:
             try:
-                process = subprocess.run([str(solver)], stdin=stdin, stdout=stdout, stderr=stderr, timeout=15000)
+                process = subprocess.run(arguments, stdin=stdin, stdout=stdout, stderr=stderr, timeout=15000)
 
                 if process.returncode != 0:
                     raise RuntimeError(f"Solver exited with status code {process.returncode} for input {input.stem}")
             except subprocess.TimeoutExpired:
                 raise RuntimeError(f"Solver timed out on input {input.stem}")
 
-    input_data = input.read_text(encoding="utf-8")
     output_data = stdout_file.read_text(encoding="utf-8")
 
-    try:
-        return get_score(input_data, output_data)
-    except ValueError as err:
-        raise RuntimeError(f"Solver provided invalid output for input {input.stem}: {str(err)}")
+    with input.open("rb") as file, mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ) as input_data:
+        try:
+            return get_score(input_data, output_data)
+        except ValueError as err:
+            raise RuntimeError(f"Solver provided invalid output for input {input.stem}: {str(err)}")
 
-def run(solver: Path, inputs: List[Path], output_directory: Path) -> None:
+def run(solver: Path, inputs: List[Path], output_directory: Path, warm: bool, solver_arguments: List[str] = []) -> None:
     if not output_directory.is_dir():
         output_directory.mkdir(parents=True)
 
     with Pool() as pool:
         try:
-            scores = pool.starmap(run_input, [(solver, input, output_directory) for input in inputs])
+            scores = pool.starmap(run_input, [(solver, input, output_directory, warm, solver_arguments) for input in inputs])
         except RuntimeError as err:
             print(f"\033[91m{str(err)}\033[0m")
             sys.exit(1)
@@ -77,6 +102,9 @@ def main() -> None:
     parser = argparse.ArgumentParser(description="Run a solver.")
     parser.add_argument("solver", type=str, help="the solver to run")
     parser.add_argument("--input", type=str, help="the input to run on (defaults to all inputs)")
+    parser.add_argument("--binary", action="store_true", help="convert the inputs to the binary format once and run on those")
+    parser.add_argument("--warm", action="store_true", help="start from the previous output of the solver on each input")
+    parser.add_argument("--strategy", type=str, help="the portfolio strategy to run, the outputs go to output/<solver>.<strategy>")
 
     args = parser.parse_args()
 
@@ -85,6 +113,11 @@ def main() -> None:
         raise RuntimeError(f"Solver not found, {solver} is not a file")
 
     output_directory = Path(__file__).parent / "output" / args.solver
+    solver_arguments = []
+
+    if args.strategy is not None:
+        output_directory = output_directory.with_name(f"{args.solver}.{args.strategy}")
+        solver_arguments.append(f"--strategy={args.strategy}")
 
     if args.input is not None:
         inputs = [Path(__file__).parent / "input" / f"{args.input}.in"]
@@ -93,7 +126,14 @@ def main() -> None:
     else:
         inputs = sorted((Path(__file__).parent / "input").glob("*.in"))
 
-    run(solver, inputs, output_directory)
+    if args.binary:
+        converter = solver.parent / "convert"
+        if not converter.is_file():
+            raise RuntimeError(f"Converter not found, {converter} is not a file")
+
+        inputs = convert_inputs(converter, inputs)
+
+    run(solver, inputs, output_directory, args.warm, solver_arguments)
     update_overview()
 
 if __name__ == "__main__":
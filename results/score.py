@@ -1,7 +1,10 @@
 import math
 import unittest
 from dataclasses import dataclass, field
-from typing import Optional
+from typing import Optional, Union
+
+INSTANCE_MAGIC = b"WF2INST\0"
+INSTANCE_VERSION = 1
 
 @dataclass
 class Machine:
@@ -52,13 +55,12 @@ class StringReader:
 
         return value
 
-def get_score(input: str, output: str) -> float:
+def read_text_input(input: str) -> tuple[dict[int, Task], dict[int, Machine], dict[int, Disk]]:
     tasks: dict[int, Task] = {}
     machines: dict[int, Machine] = {}
     disks: dict[int, Disk] = {}
 
     inp = StringReader(input)
-    out = StringReader(output)
 
     no_tasks = inp.next()
     for _ in range(no_tasks):
@@ -102,6 +104,68 @@ def get_score(input: str, output: str) -> float:
         task_j.task_dependencies.append(task_i)
         task_i.task_dependents.append(task_j)
 
+    return tasks, machines, disks
+
+def read_binary_input(input: Union[bytes, memoryview]) -> tuple[dict[int, Task], dict[int, Machine], dict[int, Disk]]:
+    """Reads an instance in the binary format written by the convert tool, see src/instance.h for the layout."""
+    nums = memoryview(input).cast("B")[len(INSTANCE_MAGIC):].cast("i")
+
+    version, no_tasks, no_machines, no_disks, no_affinities, no_data_dependencies, no_task_dependencies = nums[:7]
+    if version != INSTANCE_VERSION:
+        raise ValueError(f"Unsupported binary instance version {version}")
+
+    index = 14
+
+    def take(count: int) -> memoryview:
+        nonlocal index
+        section = nums[index:index + count]
+        index += count
+        return section
+
+    task_records = take(3 * no_tasks)
+    machine_records = take(2 * no_machines)
+    disk_records = take(3 * no_disks)
+
+    machines = [Machine(machine_records[2 * i], machine_records[2 * i + 1]) for i in range(no_machines)]
+    disks = [Disk(disk_records[3 * i], disk_records[3 * i + 1], disk_records[3 * i + 2]) for i in range(no_disks)]
+
+    affinity_offsets = take(no_tasks + 1)
+    affinities = take(no_affinities)
+
+    tasks = [Task(task_records[3 * i],
+                  task_records[3 * i + 1],
+                  task_records[3 * i + 2],
+                  [machines[m].id for m in affinities[affinity_offsets[i]:affinity_offsets[i + 1]]])
+             for i in range(no_tasks)]
+
+    for no_edges, dependencies, dependents in [(no_data_dependencies, "data_dependencies", "data_dependents"),
+                                               (no_task_dependencies, "task_dependencies", "task_dependents")]:
+        dependency_offsets = take(no_tasks + 1)
+        dependency_values = take(no_edges)
+        dependent_offsets = take(no_tasks + 1)
+        dependent_values = take(no_edges)
+
+        for i, task in enumerate(tasks):
+            setattr(task, dependencies, [tasks[j] for j in dependency_values[dependency_offsets[i]:dependency_offsets[i + 1]]])
+            setattr(task, dependents, [tasks[j] for j in dependent_values[dependent_offsets[i]:dependent_offsets[i + 1]]])
+
+    return {task.id: task for task in tasks}, {machine.id: machine for machine in machines}, {disk.id: disk for disk in disks}
+
+def read_input(input: Union[str, bytes, memoryview]) -> tuple[dict[int, Task], dict[int, Machine], dict[int, Disk]]:
+    if isinstance(input, str):
+        return read_text_input(input)
+
+    if bytes(memoryview(input)[:len(INSTANCE_MAGIC)]) == INSTANCE_MAGIC:
+        return read_binary_input(input)
+
+    return read_text_input(bytes(input).decode("utf-8"))
+
+def get_score(input: Union[str, bytes, memoryview], output: str) -> float:
+    tasks, machines, disks = read_input(input)
+    no_tasks = len(tasks)
+
+    out = StringReader(output)
+
     for _ in range(no_tasks):
         task_id = out.next()
         start_time = out.next()
@@ -143,7 +207,7 @@ def get_score(input: str, output: str) -> float:
         task.dependents = len(set(t.id for t in task.data_dependents).union(set(t.id for t in task.task_dependents)))
 
     for disk in disks.values():
-        needed_capacity = sum(task.data_size for task in tasks.values() if task.disk == disk.id)
+        needed_capacity = sum(task.data_size for task in tasks.values() if task.disk == disk)
         if needed_capacity > disk.capacity:
             raise ValueError(f"Disk {disk.id} has capacity {disk.capacity}, but {needed_capacity} is needed for given data assignment")
 
@@ -221,5 +285,13 @@ class ScoreTest(unittest.TestCase):
 
         self.assertAlmostEqual(score, example_score)
 
+    def test_get_score_disk_capacity(self) -> None:
+        input = "2\n1 1 5 1 1\n2 1 5 1 1\n1\n1 1\n2\n1 1 5\n2 1 5\n0\n0\n"
+
+        self.assertAlmostEqual(get_score(input, "1 0 1 1\n2 6 1 2\n"), 100 * (2 + 10 / 2) / 12)
+
+        with self.assertRaises(ValueError):
+            get_score(input, "1 0 1 1\n2 6 1 1\n")
+
 if __name__ == "__main__":
     unittest.main()
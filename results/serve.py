@@ -0,0 +1,120 @@
+import argparse
+import socket
+import statistics
+import subprocess
+import sys
+import time
+from pathlib import Path
+from run import convert_inputs
+from score import get_score
+from typing import BinaryIO, List, Tuple
+
+def send_request(writer: BinaryIO, reader: BinaryIO, request: bytes) -> Tuple[bool, bytes, int]:
+    writer.write(f"{len(request)}\n".encode("ascii"))
+    writer.write(request)
+    writer.flush()
+
+    header = reader.readline().decode("ascii").split()
+    if len(header) != 3 or header[0] not in ("OK", "ERR"):
+        raise RuntimeError(f"Malformed reply header {header}")
+
+    body = reader.read(int(header[1]))
+    return header[0] == "OK", body, int(header[2])
+
+def percentile(values: List[float], fraction: float) -> float:
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * fraction))]
+
+def serve(solver: Path, inputs: List[Path], socket_path: str, repeat: int, solver_arguments: List[str]) -> None:
+    process = None
+    connection = None
+
+    if socket_path is None:
+        process = subprocess.Popen([str(solver), "--serve", *solver_arguments], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        writer, reader = process.stdin, process.stdout
+    else:
+        connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        connection.connect(socket_path)
+        writer, reader = connection.makefile("wb"), connection.makefile("rb")
+
+    server_latencies = []
+    round_trips = []
+    failed = False
+
+    try:
+        for round in range(repeat):
+            for input in inputs:
+                request = input.read_bytes()
+
+                start = time.perf_counter()
+                ok, body, server_latency = send_request(writer, reader, request)
+                round_trip = (time.perf_counter() - start) * 1000
+
+                server_latencies.append(server_latency / 1000)
+                round_trips.append(round_trip)
+
+                if not ok:
+                    print(f"\033[91m{input.stem}: {body.decode('utf-8', 'replace')}\033[0m")
+                    failed = True
+                    continue
+
+                try:
+                    score = get_score(request, body.decode("utf-8"))
+                except ValueError as err:
+                    print(f"\033[91mSolver provided invalid output for input {input.stem}: {str(err)}\033[0m")
+                    failed = True
+                    continue
+
+                print(f"{input.stem}: {score:,.3f} in {server_latency / 1000:,.1f} ms ({round_trip:,.1f} ms round trip)")
+    finally:
+        writer.close()
+        reader.close()
+
+        if connection is not None:
+            connection.close()
+
+        if process is not None:
+            process.wait()
+
+    if len(server_latencies) > 1:
+        for name, latencies in (("Server", server_latencies), ("Round trip", round_trips)):
+            print(f"{name} latency: mean {statistics.mean(latencies):,.1f} ms, "
+                  f"median {statistics.median(latencies):,.1f} ms, "
+                  f"p99 {percentile(latencies, 0.99):,.1f} ms, max {max(latencies):,.1f} ms")
+
+    if failed:
+        sys.exit(1)
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Send inputs to a solver in server mode and report the latency of the requests.")
+    parser.add_argument("solver", type=str, help="the solver to start with --serve")
+    parser.add_argument("--input", type=str, help="the input to send (defaults to all inputs)")
+    parser.add_argument("--binary", action="store_true", help="convert the inputs to the binary format once and send those")
+    parser.add_argument("--socket", type=str, help="connect to a solver already listening on this Unix socket instead")
+    parser.add_argument("--repeat", type=int, default=1, help="the number of times to send every input")
+    parser.add_argument("arguments", nargs="*", help="extra arguments for the solver, after --")
+
+    args = parser.parse_args()
+
+    solver = Path(__file__).parent.parent / "cmake-build-release" / args.solver
+    if args.socket is None and not solver.is_file():
+        raise RuntimeError(f"Solver not found, {solver} is not a file")
+
+    if args.input is not None:
+        inputs = [Path(__file__).parent / "input" / f"{args.input}.in"]
+        if not inputs[0].is_file():
+            raise RuntimeError(f"Input not found, {inputs[0]} is not a file")
+    else:
+        inputs = sorted((Path(__file__).parent / "input").glob("*.in"))
+
+    if args.binary:
+        converter = Path(__file__).parent.parent / "cmake-build-release" / "convert"
+        if not converter.is_file():
+            raise RuntimeError(f"Converter not found, {converter} is not a file")
+
+        inputs = convert_inputs(converter, inputs)
+
+    serve(solver, inputs, args.socket, args.repeat, args.arguments)
+
+if __name__ == "__main__":
+    main()
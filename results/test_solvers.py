@@ -0,0 +1,303 @@
+import os
+import random
+import struct
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+from score import get_score
+from serve import send_request
+
+# Runs the built solvers on small instances, SOLVER_DIRECTORY is the build directory (defaults to cmake-build-release)
+solver_directory = Path(os.environ.get("SOLVER_DIRECTORY", Path(__file__).parent.parent / "cmake-build-release"))
+input_directory = Path(__file__).parent / "input"
+
+def run_solver(name: str, arguments: list[str], input: bytes) -> subprocess.CompletedProcess:
+    return subprocess.run([str(solver_directory / name), *arguments], input=input, capture_output=True, timeout=60)
+
+class ArgumentsTest(unittest.TestCase):
+    def test_invalid_arguments_are_rejected(self) -> None:
+        input = (input_directory / "example.in").read_bytes()
+
+        for argument, error in (("--selection=prio", b"Unknown argument --selection=prio"),
+                                ("--priorities=parallel", b"Unknown argument --priorities=parallel"),
+                                ("--select", b"Unknown argument --select"),
+                                ("--threads=x", b"Invalid value in --threads=x"),
+                                ("--lns=10ms", b"Invalid value in --lns=10ms"),
+                                ("--timeline=tree", b"Unknown timeline engine tree")):
+            process = run_solver("v08", [argument], input)
+
+            self.assertEqual(process.returncode, 1)
+            self.assertIn(error, process.stderr)
+            self.assertEqual(process.stdout, b"")
+
+    def test_invalid_exact_arguments_are_rejected(self) -> None:
+        input = (input_directory / "example.in").read_bytes()
+
+        for argument, error in (("--time-limit=0", b"Invalid value in --time-limit=0"),
+                                ("--time-limit=1s", b"Invalid value in --time-limit=1s"),
+                                ("--threads=0", b"Invalid value in --threads=0"),
+                                ("--initial", b"Unknown argument --initial")):
+            process = run_solver("exact", [argument], input)
+
+            self.assertEqual(process.returncode, 1)
+            self.assertIn(error, process.stderr)
+            self.assertEqual(process.stdout, b"")
+
+class ServeTest(unittest.TestCase):
+    def test_deadline_schedule_is_in_reply(self) -> None:
+        request = (input_directory / "sipht-30.in").read_bytes()
+
+        with subprocess.Popen([str(solver_directory / "v08"), "--serve", "--deadline=500"],
+                              stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL) as process:
+            try:
+                for _ in range(2):
+                    ok, body, _ = send_request(process.stdin, process.stdout, request)
+
+                    self.assertTrue(ok)
+                    self.assertGreater(get_score(request, body.decode("utf-8")), 0)
+            finally:
+                process.stdin.close()
+                self.assertEqual(process.stdout.read(), b"")
+
+# Twelve tasks with data on two disks that hold exactly all of it, one much faster than the other. Data-less dependents
+# make the disk order differ from the order of data sizes, so some disk orders leave data without a disk with room.
+def tight_disk_instance(seed: int) -> str:
+    rng = random.Random(seed)
+    no_tasks = 12
+
+    sizes = [rng.randint(1, 10) * 100 for _ in range(no_tasks)] + [0] * no_tasks
+    dependencies = [(i + 1, no_tasks + i + 1) for i in range(no_tasks) for _ in range(rng.randint(0, 2))]
+    fast_capacity = sum(sizes) // 2
+
+    lines = [str(len(sizes))]
+    lines += [f"{i + 1} 10 {size} 1 1" for i, size in enumerate(sizes)]
+    lines += ["1", "1 1", "2", f"1 100 {fast_capacity}", f"2 1 {sum(sizes) - fast_capacity}"]
+    lines += [str(len(dependencies))] + [f"{a} {b}" for a, b in dependencies] + ["0"]
+
+    return "\n".join(lines) + "\n"
+
+class TimelineTest(unittest.TestCase):
+    def test_empty_task_waits_for_busy_machine(self) -> None:
+        # Task 2 takes no time, but the machine is busy with task 1 from time 0
+        input = "2\n1 10 0 1 1\n2 0 0 1 1\n1\n1 1\n1\n1 1 100\n0\n0\n"
+
+        for engine in ("intervals", "bitmap"):
+            process = run_solver("v08", [f"--timeline={engine}"], input.encode())
+
+            self.assertEqual(process.returncode, 0)
+            self.assertEqual(get_score(input, process.stdout.decode()), 100)
+
+class EvolutionTest(unittest.TestCase):
+    def test_tight_disks_stay_within_capacity(self) -> None:
+        for seed in (7, 8):
+            input = tight_disk_instance(seed)
+
+            # A target below the lower bound keeps the search going for the whole time limit
+            process = run_solver("v08", ["--evolve=200", "--gap=-100"], input.encode())
+
+            self.assertEqual(process.returncode, 0)
+            get_score(input, process.stdout.decode())
+
+class WarmStartTest(unittest.TestCase):
+    def test_previous_disks_leave_no_room(self) -> None:
+        input = "4\n1 10 600 1 1\n2 10 400 1 1\n3 10 500 1 1\n4 10 500 1 1\n1\n1 1\n2\n1 100 1000\n2 1 1000\n0\n0\n"
+
+        # Task 1 is new and its data fits on neither disk next to the previous data
+        with tempfile.NamedTemporaryFile("w", suffix=".out") as previous:
+            previous.write("2 0 1 1\n3 4 1 1\n4 9 1 2\n")
+            previous.flush()
+
+            process = run_solver("v08", [f"--warm={previous.name}"], input.encode())
+
+        self.assertEqual(process.returncode, 0)
+        get_score(input, process.stdout.decode())
+
+class PortfolioTest(unittest.TestCase):
+    def test_strategy_error_is_reported(self) -> None:
+        input = "2\n1 10 600 1 1\n2 10 600 1 1\n1\n1 1\n2\n1 10 1000\n2 1 1000\n0\n0\n"
+
+        # Without disk 2 the data of both tasks does not fit, which the v08 strategies throw on from worker threads
+        with tempfile.NamedTemporaryFile("w", suffix=".out") as previous:
+            previous.write("1 0 1 1\n2 61 1 2\n")
+            previous.flush()
+
+            for _ in range(5):
+                process = run_solver("v08", ["--portfolio", "--threads=4", f"--repair={previous.name}", "--remove-disk=2"],
+                                     input.encode())
+
+                self.assertEqual(process.returncode, 1)
+                self.assertIn(b"No remaining disk has room", process.stderr)
+
+    def test_schedule_does_not_depend_on_timing(self) -> None:
+        # Several strategies meet the lower bound of these, the earliest of them must win every time
+        for name in ("random-6-0", "random-10-0"):
+            input = (input_directory / f"{name}.in").read_bytes()
+            outputs = {run_solver("v08", ["--portfolio", "--threads=4"], input).stdout for _ in range(5)}
+
+            self.assertEqual(len(outputs), 1)
+
+    def test_improvement_phases_are_not_cancelled(self) -> None:
+        # The first schedule to meet the lower bound of this one must not cancel the others before they improve
+        input = (input_directory / "random-10-0.in").read_bytes()
+        process = run_solver("v08", ["--portfolio", "--threads=4", "--justify=1"], input)
+
+        self.assertEqual(process.returncode, 0)
+        self.assertNotRegex(process.stderr, rb"Strategy v08[^:]*: gave up")
+
+class PrioritiesTest(unittest.TestCase):
+    def test_level_priorities_match_serial(self) -> None:
+        # One large component is prioritized level by level in parallel (random-10000-500000), many components each on
+        # their own thread (the others)
+        for name in ("montage-10000", "sipht-10000", "random-10000-0", "random-10000-500000"):
+            input = (input_directory / f"{name}.in").read_bytes()
+            serial = run_solver("v08", ["--priorities=serial"], input)
+            levels = run_solver("v08", ["--priorities=levels", "--threads=4"], input)
+
+            self.assertEqual(serial.returncode, 0)
+            self.assertEqual(levels.returncode, 0)
+            self.assertEqual(levels.stdout, serial.stdout)
+
+class SpeculationTest(unittest.TestCase):
+    def test_speculation_matches_serial(self) -> None:
+        # Speculated options on a machine taken earlier in the round are recomputed (random-10000-0), and tasks that
+        # become ready in between return the rest of the round to the queue (montage-10000)
+        for name in ("random-10000-0", "montage-10000"):
+            input = (input_directory / f"{name}.in").read_bytes()
+            serial = run_solver("v08", ["--speculation=1"], input)
+
+            self.assertEqual(serial.returncode, 0)
+
+            for depth in (8, 32):
+                speculative = run_solver("v08", [f"--speculation={depth}", "--threads=4"], input)
+
+                self.assertEqual(speculative.returncode, 0)
+                self.assertEqual(speculative.stdout, serial.stdout)
+
+class MachineClassesTest(unittest.TestCase):
+    def test_classes_match_scan(self) -> None:
+        # Both engines place tasks into earlier free intervals, and min-min queries every ready task after each choice
+        for name in ("random-10000-0", "montage-10000", "cybershake-1000"):
+            input = (input_directory / f"{name}.in").read_bytes()
+
+            for arguments in (["--timeline=intervals"], ["--timeline=bitmap"], ["--selection=minmin"]):
+                scan = run_solver("v08", [*arguments, "--machines=scan"], input)
+                classes = run_solver("v08", [*arguments, "--machines=classes"], input)
+
+                self.assertEqual(scan.returncode, 0)
+                self.assertEqual(classes.returncode, 0)
+                self.assertEqual(classes.stdout, scan.stdout)
+
+class ExactTest(unittest.TestCase):
+    def test_infeasible_initial_schedule_is_replayed(self) -> None:
+        input = (input_directory / "example.in").read_bytes()
+        schedule = run_solver("exact", [], input).stdout.decode()
+
+        # Every task at time 0 ignores the dependencies and overlaps on the machines
+        with tempfile.NamedTemporaryFile("w", suffix=".out") as initial:
+            for line in schedule.splitlines():
+                id, _, machine, disk = line.split()
+                initial.write(f"{id} 0 {machine} {disk}\n")
+
+            initial.flush()
+            process = run_solver("exact", [f"--initial={initial.name}"], input)
+
+            self.assertEqual(process.returncode, 0)
+            self.assertEqual(get_score(input, process.stdout.decode()), get_score(input, schedule))
+
+            initial.write("99 0 1 1\n")
+            initial.flush()
+            process = run_solver("exact", [f"--initial={initial.name}"], input)
+
+            self.assertEqual(process.returncode, 1)
+            self.assertIn(b"unknown task 99", process.stderr)
+
+class OnlineTest(unittest.TestCase):
+    # Three tasks on one machine and disk, submitted in order, with the given data and task dependencies
+    @staticmethod
+    def instance(data_dependencies: list[tuple[int, int]], task_dependencies: list[tuple[int, int]]) -> bytes:
+        lines = ["3", "1 1 1 1 1", "2 1 1 1 1", "3 1 1 1 1", "1", "1 1", "1", "1 10 100"]
+        for dependencies in (data_dependencies, task_dependencies):
+            lines += [str(len(dependencies))] + [f"{a} {b}" for a, b in dependencies]
+
+        return ("\n".join(lines) + "\n").encode()
+
+    def test_invalid_dependencies_are_rejected(self) -> None:
+        for data_dependencies, task_dependencies, error in (([(1, 1)], [], b"Task 1 depends on itself"),
+                                                            ([(3, 1), (1, 2)], [(2, 3)], b"Task 3 closes a cycle")):
+            process = run_solver("online", [], self.instance(data_dependencies, task_dependencies))
+
+            self.assertEqual(process.returncode, 1)
+            self.assertIn(error, process.stderr)
+
+    def test_dependencies_submitted_later(self) -> None:
+        input = self.instance([(3, 1), (1, 2)], [(3, 2)])
+        process = run_solver("online", [], input)
+
+        self.assertEqual(process.returncode, 0)
+        get_score(input, process.stdout.decode())
+
+class TextInputTest(unittest.TestCase):
+    def test_negative_counts_are_rejected(self) -> None:
+        for input in (b"-1\n", b"1\n1 10 10 -2 1\n1\n1 1\n1\n1 1 100\n0\n0\n",
+                      b"1\n1 10 10 1 1\n1\n1 1\n1\n1 1 100\n-3\n0\n"):
+            for name in ("v08", "v05"):
+                process = run_solver(name, [], input)
+
+                self.assertEqual(process.returncode, 1)
+                self.assertIn(b"Text instance has invalid counts", process.stderr)
+
+class BinaryInputTest(unittest.TestCase):
+    def test_corrupted_instances_are_rejected(self) -> None:
+        with tempfile.TemporaryDirectory() as directory:
+            binary_file = Path(directory) / "example.bin"
+            subprocess.run([str(solver_directory / "convert"), str(input_directory / "example.in"), str(binary_file)],
+                           check=True)
+
+            image = binary_file.read_bytes()
+            no_tasks, no_machines, no_disks = struct.unpack_from("<3I", image, 12)
+            affinity_offsets = 16 + 3 * no_tasks + 2 * no_machines + 3 * no_disks
+
+            def corrupt(index: int, value: int) -> bytes:
+                corrupted = bytearray(image)
+                struct.pack_into("<i", corrupted, 4 * index, value)
+                return bytes(corrupted)
+
+            corruptions = {
+                b"is truncated": image[:100],
+                b"invalid counts": corrupt(3, -1),
+                b"inconsistent CSR offsets": corrupt(affinity_offsets + 2, 1),
+                b"affinity 99 out of range": corrupt(affinity_offsets + no_tasks + 1, 99),
+            }
+
+            self.assertEqual(run_solver("v08", [], image).returncode, 0)
+
+            for error, corrupted in corruptions.items():
+                # Through a pipe and from a file, which is memory-mapped
+                corrupted_file = Path(directory) / "corrupted.bin"
+                corrupted_file.write_bytes(corrupted)
+
+                with corrupted_file.open("rb") as stdin:
+                    mapped = subprocess.run([str(solver_directory / "v08")], stdin=stdin, capture_output=True, timeout=60)
+
+                for process in (run_solver("v08", [], corrupted), mapped):
+                    self.assertEqual(process.returncode, 1)
+                    self.assertIn(error, process.stderr)
+
+    def test_list_solvers_read_binary_instances(self) -> None:
+        text_file = input_directory / "cybershake-30.in"
+
+        with tempfile.TemporaryDirectory() as directory:
+            binary_file = Path(directory) / "cybershake-30.bin"
+            subprocess.run([str(solver_directory / "convert"), str(text_file), str(binary_file)], check=True)
+
+            for name in ("v01", "v05", "list-ready-activity-intervals-end"):
+                text = run_solver(name, [], text_file.read_bytes())
+                binary = run_solver(name, [], binary_file.read_bytes())
+
+                self.assertEqual(binary.returncode, 0)
+                self.assertNotEqual(binary.stdout, b"")
+                self.assertEqual(binary.stdout, text.stdout)
+
+if __name__ == "__main__":
+    unittest.main()
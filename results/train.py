@@ -0,0 +1,162 @@
+import argparse
+import subprocess
+from pathlib import Path
+from run import run
+from typing import Dict, List, Optional, Tuple
+
+# The strategies of the v08 portfolio, in the order the portfolio prefers them on ties
+STRATEGIES = ["v08", "v08-urgent", "v08-urgent-10", "v08-urgent-100", "v05", "v04", "v03"]
+
+Features = Dict[str, float]
+Scores = Dict[str, float]
+
+class Node:
+    def __init__(self, strategy: str, feature: Optional[str] = None, threshold: float = 0,
+                 below: Optional["Node"] = None, above: Optional["Node"] = None) -> None:
+        self.strategy = strategy
+        self.feature = feature
+        self.threshold = threshold
+        self.below = below
+        self.above = above
+
+    def select(self, features: Features) -> str:
+        if self.feature is None:
+            return self.strategy
+
+        return (self.below if features[self.feature] <= self.threshold else self.above).select(features)
+
+def read_features(solver: Path, input: Path) -> Features:
+    with input.open("rb") as stdin:
+        process = subprocess.run([str(solver), "--features"], stdin=stdin, capture_output=True, check=True)
+
+    features = {}
+    for line in process.stdout.decode("utf-8").splitlines():
+        name, value = line.split()
+        features[name] = float(value)
+
+    return features
+
+def read_scores(outputs_root: Path, solver: str, input: Path) -> Scores:
+    scores = {}
+    for strategy in STRATEGIES:
+        score_file = outputs_root / f"{solver}.{strategy}" / f"{input.stem}.txt"
+        if not score_file.is_file():
+            raise RuntimeError(f"Score not found, {score_file} is not a file, run with --run first")
+
+        scores[strategy] = float(score_file.read_text(encoding="utf-8").strip())
+
+    return scores
+
+# Another strategy replaces the first one only if it is ahead by the margin in total, so a few inputs where it happens
+# to be better do not decide a leaf
+def best_strategy(samples: List[Tuple[Features, Scores]], margin: float) -> Tuple[str, float]:
+    totals = [sum(scores[strategy] for _, scores in samples) for strategy in STRATEGIES]
+    best = max(range(len(STRATEGIES)), key=lambda i: (totals[i] - (margin if i > 0 else 0), -i))
+    return STRATEGIES[best], totals[best]
+
+# Grows a tree that maximizes the total score of the strategies picked at its leaves
+def train(samples: List[Tuple[Features, Scores]], depth: int, min_leaf_size: int, margin: float) -> Node:
+    strategy, total = best_strategy(samples, margin)
+    node = Node(strategy)
+
+    if depth == 0 or len(samples) < 2 * min_leaf_size:
+        return node
+
+    best_gain = margin
+    for feature in samples[0][0]:
+        values = sorted(set(features[feature] for features, _ in samples))
+
+        for low, high in zip(values, values[1:]):
+            threshold = (low + high) / 2
+
+            below = [sample for sample in samples if sample[0][feature] <= threshold]
+            above = [sample for sample in samples if sample[0][feature] > threshold]
+            if len(below) < min_leaf_size or len(above) < min_leaf_size:
+                continue
+
+            gain = best_strategy(below, margin)[1] + best_strategy(above, margin)[1] - total
+            if gain > best_gain:
+                best_gain = gain
+                node.feature = feature
+                node.threshold = threshold
+
+    if node.feature is not None:
+        below = [sample for sample in samples if sample[0][node.feature] <= node.threshold]
+        above = [sample for sample in samples if sample[0][node.feature] > node.threshold]
+
+        node.below = train(below, depth - 1, min_leaf_size, margin)
+        node.above = train(above, depth - 1, min_leaf_size, margin)
+
+    return node
+
+def write_node(node: Node, indent: str) -> List[str]:
+    if node.feature is None:
+        return [f"{indent}return \"{node.strategy}\";"]
+
+    return [f"{indent}if (features.{node.feature} <= {node.threshold!r}) {{",
+            *write_node(node.below, indent + "    "),
+            f"{indent}}}",
+            "",
+            *write_node(node.above, indent)]
+
+def write_selector(tree: Node, selector_file: Path, no_inputs: int) -> None:
+    lines = ["#pragma once",
+             "",
+             "#include <string>",
+             "",
+             "#include \"features.h\"",
+             "",
+             f"// Generated by results/train.py from the scores of the v08 portfolio strategies on {no_inputs} inputs",
+             "inline std::string selectStrategy(const InstanceFeatures &features) {",
+             *write_node(tree, "    "),
+             "}"]
+
+    selector_file.write_text("\n".join(lines) + "\n", encoding="utf-8")
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Train the strategy selector of a solver from the scores of its portfolio strategies.")
+    parser.add_argument("solver", type=str, help="the solver with the portfolio")
+    parser.add_argument("--run", action="store_true", help="run every strategy on all inputs first")
+    parser.add_argument("--depth", type=int, default=3, help="the maximum depth of the decision tree")
+    parser.add_argument("--min-leaf-size", type=int, default=5, help="the minimum number of inputs in a leaf")
+    parser.add_argument("--margin", type=float, default=0.5, help="the total score by which a split or another strategy has to win")
+    parser.add_argument("--dry-run", action="store_true", help="report the selector without writing src/selector.h")
+
+    args = parser.parse_args()
+
+    solver = Path(__file__).parent.parent / "cmake-build-release" / args.solver
+    if not solver.is_file():
+        raise RuntimeError(f"Solver not found, {solver} is not a file")
+
+    outputs_root = Path(__file__).parent / "output"
+    inputs = sorted((Path(__file__).parent / "input").glob("*.in"))
+
+    if args.run:
+        for strategy in STRATEGIES:
+            print(f"Running strategy {strategy}")
+            run(solver, inputs, outputs_root / f"{args.solver}.{strategy}", False, [f"--strategy={strategy}"])
+
+    samples = [(read_features(solver, input), read_scores(outputs_root, args.solver, input)) for input in inputs]
+
+    # Every input is scored by a tree trained on the other inputs
+    left_out_total = 0
+    for i in range(len(samples)):
+        tree = train(samples[:i] + samples[i + 1:], args.depth, args.min_leaf_size, args.margin)
+        left_out_total += samples[i][1][tree.select(samples[i][0])]
+
+    tree = train(samples, args.depth, args.min_leaf_size, args.margin)
+    trained_total = sum(scores[tree.select(features)] for features, scores in samples)
+
+    print(f"Strategy {STRATEGIES[0]}: {sum(scores[STRATEGIES[0]] for _, scores in samples):,.3f}")
+    best_single, best_single_total = best_strategy(samples, 0)
+    print(f"Best single strategy {best_single}: {best_single_total:,.3f}")
+    print(f"Selector: {trained_total:,.3f}, {left_out_total:,.3f} on inputs left out of training")
+    print(f"Best strategy per input: {sum(max(scores.values()) for _, scores in samples):,.3f}")
+
+    if not args.dry_run:
+        selector_file = Path(__file__).parent.parent / "src" / "selector.h"
+        write_selector(tree, selector_file, len(samples))
+        print(f"Selector: {selector_file.resolve()}")
+
+if __name__ == "__main__":
+    main()
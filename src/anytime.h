@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <csignal>
+#include <string>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+// Keeps the best complete schedule formatted as solver output, so it can be written out at any time.
+// On SIGTERM or SIGALRM the handler writes the last published schedule and exits, or exits with status 1 if no
+// schedule was published yet. Schedules are formatted into the buffer that is not published and then swapped in,
+// so the handler never sees a half-written one. Only the thread that calls install() takes the signals, other
+// threads have to be started after blockSignals() so they inherit the blocked mask.
+struct AnytimeOutput {
+    // Blocks the signals on the calling thread and the threads it starts from now on
+    static void blockSignals() {
+        sigset_t signals = flushSignals();
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    }
+
+    // Installs the handler and unblocks the signals on the calling thread. A positive deadline arms a timer that
+    // raises SIGALRM after deadlineMs milliseconds.
+    static void install(int deadlineMs) {
+        struct sigaction action{};
+        action.sa_handler = handle;
+        sigemptyset(&action.sa_mask);
+
+        sigaction(SIGTERM, &action, nullptr);
+        sigaction(SIGALRM, &action, nullptr);
+
+        if (deadlineMs > 0) {
+            itimerval timer{};
+            timer.it_value.tv_sec = deadlineMs / 1000;
+            timer.it_value.tv_usec = (deadlineMs % 1000) * 1000;
+            setitimer(ITIMER_REAL, &timer, nullptr);
+        }
+
+        sigset_t signals = flushSignals();
+        pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+    }
+
+    // Formats a schedule of noTasks tasks and publishes it, fieldsOf(i) returns the id, start time, machine id and
+    // disk id of the i-th task
+    template<typename F>
+    static void publish(int noTasks, F &&fieldsOf) {
+        int next = published.load(std::memory_order_relaxed) == 0 ? 1 : 0;
+        std::string &buffer = buffers[next];
+
+        buffer.clear();
+
+        char line[64];
+        for (int i = 0; i < noTasks; i++) {
+            auto [id, startTime, machine, disk] = fieldsOf(i);
+
+            char *end = line;
+            end = std::to_chars(end, line + sizeof(line), id).ptr;
+            *end++ = ' ';
+            end = std::to_chars(end, line + sizeof(line), startTime).ptr;
+            *end++ = ' ';
+            end = std::to_chars(end, line + sizeof(line), machine).ptr;
+            *end++ = ' ';
+            end = std::to_chars(end, line + sizeof(line), disk).ptr;
+            *end++ = '\n';
+
+            buffer.append(line, end);
+        }
+
+        published.store(next, std::memory_order_release);
+    }
+
+    // Writes the last published schedule on normal completion, with the signals blocked so it is written only once
+    static void finish() {
+        blockSignals();
+        write(published.load(std::memory_order_acquire));
+    }
+
+private:
+    static inline std::string buffers[2];
+    static inline std::atomic<int> published = -1;
+
+    static sigset_t flushSignals() {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGTERM);
+        sigaddset(&signals, SIGALRM);
+
+        return signals;
+    }
+
+    static void handle(int) {
+        int current = published.load(std::memory_order_acquire);
+        if (current < 0) {
+            _exit(1);
+        }
+
+        write(current);
+        _exit(0);
+    }
+
+    // Only async-signal-safe calls, this runs in the handler
+    static void write(int current) {
+        if (current < 0) {
+            return;
+        }
+
+        const char *data = buffers[current].data();
+        std::size_t remaining = buffers[current].size();
+
+        while (remaining > 0) {
+            ssize_t written = ::write(STDOUT_FILENO, data, remaining);
+            if (written <= 0) {
+                break;
+            }
+
+            data += written;
+            remaining -= written;
+        }
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+// Bump allocator that hands out memory from a few large chunks and releases everything at once on destruction.
+// Individual deallocations are no-ops, which suits graph structures that live as long as the solver does.
+struct Arena {
+    struct Stats {
+        std::size_t allocations = 0;
+        std::size_t usedBytes = 0;
+        std::size_t reservedBytes = 0;
+        std::size_t chunks = 0;
+    };
+
+    Arena() = default;
+
+    explicit Arena(std::size_t initialChunkSize) : nextChunkSize(initialChunkSize) {
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena() {
+        release();
+    }
+
+    // Sets the size of the next chunk, call before the first allocation to fit everything into a single chunk.
+    void reserve(std::size_t bytes) {
+        nextChunkSize = std::max(nextChunkSize, bytes);
+    }
+
+    void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        std::size_t offset = (used + alignment - 1) & ~(alignment - 1);
+
+        if (chunks.empty() || offset + bytes > capacity) {
+            addChunk(bytes + alignment);
+            offset = (used + alignment - 1) & ~(alignment - 1);
+        }
+
+        used = offset + bytes;
+
+        stats.allocations++;
+        stats.usedBytes += bytes;
+
+        return chunks.back() + offset;
+    }
+
+    // Forgets all allocations but keeps the memory around, merging multiple chunks into one on the next allocation.
+    void reset() {
+        if (chunks.size() > 1) {
+            std::size_t total = stats.reservedBytes;
+            release();
+            nextChunkSize = total;
+        }
+
+        used = 0;
+
+        stats.allocations = 0;
+        stats.usedBytes = 0;
+    }
+
+    [[nodiscard]] const Stats &getStats() const {
+        return stats;
+    }
+
+private:
+    std::vector<std::byte *> chunks;
+
+    std::size_t capacity = 0;
+    std::size_t used = 0;
+
+    std::size_t nextChunkSize = 1 << 16;
+
+    Stats stats;
+
+    void addChunk(std::size_t minimumSize) {
+        std::size_t size = std::max(nextChunkSize, minimumSize);
+
+        auto *chunk = static_cast<std::byte *>(std::malloc(size));
+        if (chunk == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        chunks.push_back(chunk);
+
+        capacity = size;
+        used = 0;
+        nextChunkSize = size * 2;
+
+        stats.reservedBytes += size;
+        stats.chunks++;
+    }
+
+    void release() {
+        for (auto *chunk : chunks) {
+            std::free(chunk);
+        }
+
+        chunks.clear();
+
+        capacity = 0;
+        used = 0;
+
+        stats.reservedBytes = 0;
+        stats.chunks = 0;
+    }
+};
+
+template<typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    Arena *arena;
+
+    ArenaAllocator(Arena &arena) : arena(&arena) {
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {
+    }
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, std::size_t) {
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template<typename T>
+using ArenaSet = std::unordered_set<T, std::hash<T>, std::equal_to<T>, ArenaAllocator<T>>;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// Value of a numeric argument, which must be a whole number of at least minimum
+inline int parseInt(const std::string &arg, const std::string &value, int minimum = std::numeric_limits<int>::min()) {
+    std::size_t length = 0;
+    int number = 0;
+
+    try {
+        number = std::stoi(value, &length);
+    } catch (const std::exception &) {
+        length = 0;
+    }
+
+    if (length == 0 || length != value.size() || number < minimum) {
+        throw std::invalid_argument("Invalid value in " + arg);
+    }
+
+    return number;
+}
+
+inline double parseDouble(const std::string &arg, const std::string &value) {
+    std::size_t length = 0;
+    double number = 0;
+
+    try {
+        number = std::stod(value, &length);
+    } catch (const std::exception &) {
+        length = 0;
+    }
+
+    if (length == 0 || length != value.size() || !std::isfinite(number)) {
+        throw std::invalid_argument("Invalid value in " + arg);
+    }
+
+    return number;
+}
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "timeline.h"
+
+// Replays a list-scheduling workload against both timeline engines: every task queries all machines for the
+// earliest fit after its ready time and is reserved on the machine where it ends first.
+// Ready times are a random fraction of the current makespan, so tasks keep falling into gaps and fragment the timelines.
+// Restricting tasks to a few affinity machines leaves gaps behind on machines that are free long before a task is ready,
+// which is what makes the interval lists long.
+struct Query {
+    double readiness = 0;
+    int duration = 0;
+    int firstMachine = 0;
+};
+
+std::vector<int> replay(TimelineEngine engine,
+                        const std::vector<Query> &queries,
+                        int noMachines,
+                        int noAffinities,
+                        double &elapsed) {
+    Arena arena;
+
+    std::vector<Timeline> timelines;
+    timelines.reserve(noMachines);
+    for (int i = 0; i < noMachines; i++) {
+        timelines.emplace_back(arena, engine);
+    }
+
+    std::vector<int> startTimes;
+    startTimes.reserve(queries.size());
+
+    int makespan = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (const auto &query : queries) {
+        int minStartTime = (int) (query.readiness * makespan);
+
+        int bestMachine = -1;
+        int bestStartTime = -1;
+
+        for (int j = 0; j < noAffinities; j++) {
+            int i = (query.firstMachine + j) % noMachines;
+            int startTime = timelines[i].earliestFit(minStartTime, query.duration + i % 7);
+            if (bestMachine == -1 || startTime + i % 7 < bestStartTime + bestMachine % 7) {
+                bestMachine = i;
+                bestStartTime = startTime;
+            }
+        }
+
+        int endTime = bestStartTime + query.duration + bestMachine % 7;
+
+        timelines[bestMachine].reserve(bestStartTime, endTime);
+        startTimes.push_back(bestStartTime);
+
+        makespan = std::max(makespan, endTime);
+    }
+
+    elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    return startTimes;
+}
+
+int main(int argc, char *argv[]) {
+    int noTasks = argc > 1 ? std::stoi(argv[1]) : 10000;
+    int noMachines = argc > 2 ? std::stoi(argv[2]) : 50;
+    int noAffinities = argc > 3 ? std::stoi(argv[3]) : noMachines;
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> taskSizes(10, 600);
+    std::uniform_int_distribution<int> powers(1, 20);
+    std::uniform_real_distribution<double> readiness(0.0, 1.0);
+    std::uniform_int_distribution<int> machines(0, noMachines - 1);
+
+    std::vector<Query> queries(noTasks);
+    for (auto &query : queries) {
+        query.readiness = readiness(random);
+        int taskSize = taskSizes(random);
+        int power = powers(random);
+
+        query.duration = (taskSize + power - 1) / power;
+        query.firstMachine = machines(random);
+    }
+
+    double intervalsTime;
+    double bitmapTime;
+
+    auto intervals = replay(TimelineEngine::Intervals, queries, noMachines, noAffinities, intervalsTime);
+    auto bitmap = replay(TimelineEngine::Bitmap, queries, noMachines, noAffinities, bitmapTime);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << noTasks << " tasks on " << noMachines << " machines, " << noAffinities << " affinities per task\n"
+              << "intervals: " << intervalsTime << " ms\n"
+              << "bitmap:    " << bitmapTime << " ms\n";
+
+    if (intervals != bitmap) {
+        std::cerr << "Engines disagree on the schedule" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
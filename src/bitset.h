@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+#include "arena.h"
+
+// Set of integers in [0, universe) as a bitset. Sets over up to 128 integers keep their words inline,
+// larger ones fall back to words allocated from an arena.
+struct BitSet {
+    static constexpr int inlineWords = 2;
+
+    BitSet() = default;
+
+    BitSet(Arena &arena, int universe) : noWords((universe + 63) / 64) {
+        if (noWords > inlineWords) {
+            external = static_cast<std::uint64_t *>(arena.allocate(noWords * sizeof(std::uint64_t),
+                                                                   alignof(std::uint64_t)));
+            std::fill(external, external + noWords, 0);
+        }
+    }
+
+    [[nodiscard]] std::span<std::uint64_t> words() {
+        return {noWords > inlineWords ? external : inlineStorage, (std::size_t) noWords};
+    }
+
+    [[nodiscard]] std::span<const std::uint64_t> words() const {
+        return {noWords > inlineWords ? external : inlineStorage, (std::size_t) noWords};
+    }
+
+    void insert(int i) {
+        words()[i / 64] |= 1ull << (i % 64);
+    }
+
+    void erase(int i) {
+        words()[i / 64] &= ~(1ull << (i % 64));
+    }
+
+    [[nodiscard]] bool contains(int i) const {
+        return (words()[i / 64] >> (i % 64) & 1) != 0;
+    }
+
+    [[nodiscard]] int count() const {
+        int count = 0;
+        for (std::uint64_t word : words()) {
+            count += std::popcount(word);
+        }
+
+        return count;
+    }
+
+    // Sets over different universes compare over the words both have
+    [[nodiscard]] bool intersects(const BitSet &other) const {
+        auto a = words();
+        auto b = other.words();
+
+        for (std::size_t w = 0; w < std::min(a.size(), b.size()); w++) {
+            if ((a[w] & b[w]) != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    std::uint64_t inlineStorage[inlineWords] = {};
+    std::uint64_t *external = nullptr;
+    int noWords = 0;
+};
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "instance.h"
+
+// Lower bounds on the makespan of any schedule, so improvement searches can stop once the incumbent is provably close
+// to optimal. Every task takes at least its minimum duration: its data dependencies written to their fastest disks
+// large enough to hold them, itself run on its fastest affinity machine and written to its fastest disk large enough.
+struct LowerBounds {
+    // Longest dependency chain of minimum durations, a task dependency only waits for the run to end
+    int criticalPath = 0;
+
+    // For a set of machines, the tasks that can only run on them need their minimum durations on these machines
+    // and their total size at the combined power. Checked for the affinity sets of the tasks and all machines.
+    int affinityLoad = 0;
+
+    // All machines together are busy for at least the total minimum run time plus the cheapest way to read and write
+    // all data, with every disk holding at most its capacity
+    int diskTraffic = 0;
+
+    // Minimum time from the end of a task's write, respectively its run, to the end of any schedule: the longest chain
+    // of minimum durations among its data, respectively task, dependents
+    std::vector<int> tailAfterWrite;
+    std::vector<int> tailAfterRun;
+
+    static constexpr int maxCandidateSets = 1024;
+
+    LowerBounds() = default;
+
+    explicit LowerBounds(const Instance &instance) {
+        int n = instance.noTasks();
+
+        std::vector<int> minRunTime(n);
+        std::vector<int> minWriteTime(n);
+        std::vector<int> minDuration(n);
+
+        for (int i = 0; i < n; i++) {
+            int maxPower = 1;
+            for (int machine : instance.affinitiesOf(i)) {
+                maxPower = std::max(maxPower, (int) instance.machines[machine].power);
+            }
+
+            minRunTime[i] = ceilDivide(instance.tasks[i].taskSize, maxPower);
+
+            int maxSpeed = 0;
+            for (int disk = 0; disk < instance.noDisks(); disk++) {
+                if (instance.disks[disk].capacity >= instance.tasks[i].dataSize) {
+                    maxSpeed = std::max(maxSpeed, (int) instance.disks[disk].speed);
+                }
+            }
+
+            minWriteTime[i] = maxSpeed > 0 ? ceilDivide(instance.tasks[i].dataSize, maxSpeed) : 0;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int minReadTime = 0;
+            for (int d : instance.dataDependenciesOf(i)) {
+                minReadTime += minWriteTime[d];
+            }
+
+            minDuration[i] = minReadTime + minRunTime[i] + minWriteTime[i];
+        }
+
+        setCriticalPath(instance, minWriteTime, minDuration);
+        setAffinityLoad(instance, minDuration);
+        setDiskTraffic(instance, minRunTime);
+    }
+
+    [[nodiscard]] int value() const {
+        return std::max({criticalPath, affinityLoad, diskTraffic});
+    }
+
+private:
+    static int ceilDivide(long long a, long long b) {
+        return (int) ((a + b - 1) / b);
+    }
+
+    void setCriticalPath(const Instance &instance, const std::vector<int> &minWriteTime, const std::vector<int> &minDuration) {
+        int n = instance.noTasks();
+
+        std::vector<int> remainingDependencies(n);
+        std::vector<int> order;
+        order.reserve(n);
+
+        for (int i = 0; i < n; i++) {
+            remainingDependencies[i] = (int) (instance.dataDependenciesOf(i).size() + instance.taskDependenciesOf(i).size());
+            if (remainingDependencies[i] == 0) {
+                order.push_back(i);
+            }
+        }
+
+        std::vector<int> head(n);
+        tailAfterWrite.assign(n, 0);
+        tailAfterRun.assign(n, 0);
+
+        for (std::size_t k = 0; k < order.size(); k++) {
+            int i = order[k];
+            criticalPath = std::max(criticalPath, head[i] + minDuration[i]);
+
+            for (int j : instance.dataDependentsOf(i)) {
+                head[j] = std::max(head[j], head[i] + minDuration[i]);
+                if (--remainingDependencies[j] == 0) {
+                    order.push_back(j);
+                }
+            }
+
+            for (int j : instance.taskDependentsOf(i)) {
+                head[j] = std::max(head[j], head[i] + minDuration[i] - minWriteTime[i]);
+                if (--remainingDependencies[j] == 0) {
+                    order.push_back(j);
+                }
+            }
+        }
+
+        // Time from the start of a task to the end of the schedule, its run ends minWriteTime before its write
+        auto tailAfterStart = [&](int j) {
+            return std::max(minDuration[j] + tailAfterWrite[j], minDuration[j] - minWriteTime[j] + tailAfterRun[j]);
+        };
+
+        for (auto k = (int) order.size() - 1; k >= 0; k--) {
+            int i = order[k];
+
+            for (int j : instance.dataDependentsOf(i)) {
+                tailAfterWrite[i] = std::max(tailAfterWrite[i], tailAfterStart(j));
+            }
+
+            for (int j : instance.taskDependentsOf(i)) {
+                tailAfterRun[i] = std::max(tailAfterRun[i], tailAfterStart(j));
+            }
+        }
+    }
+
+    void setAffinityLoad(const Instance &instance, const std::vector<int> &minDuration) {
+        int n = instance.noTasks();
+        int noWords = (instance.noMachines() + 63) / 64;
+
+        // Tasks with the same affinities are merged, their durations and sizes summed
+        struct AffinitySet {
+            std::vector<std::uint64_t> words;
+            int noMachines = 0;
+            long long power = 0;
+
+            long long duration = 0;
+            long long size = 0;
+        };
+
+        std::vector<AffinitySet> sets;
+        std::unordered_map<std::uint64_t, std::vector<int>> setsOfHash;
+
+        for (int i = 0; i < n; i++) {
+            std::vector<std::uint64_t> words(noWords);
+            for (int machine : instance.affinitiesOf(i)) {
+                words[machine / 64] |= 1ull << (machine % 64);
+            }
+
+            std::uint64_t hash = 0;
+            for (std::uint64_t word : words) {
+                hash = (hash ^ word) * 0x100000001b3ull;
+            }
+
+            auto &candidates = setsOfHash[hash];
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](int s) { return sets[s].words == words; });
+
+            int s;
+            if (it != candidates.end()) {
+                s = *it;
+            } else {
+                s = (int) sets.size();
+                candidates.push_back(s);
+
+                AffinitySet &set = sets.emplace_back();
+                set.words = words;
+                for (int machine : instance.affinitiesOf(i)) {
+                    set.noMachines++;
+                    set.power += instance.machines[machine].power;
+                }
+            }
+
+            sets[s].duration += minDuration[i];
+            sets[s].size += instance.tasks[i].taskSize;
+        }
+
+        auto boundOf = [](long long duration, long long size, int noMachines, long long power) {
+            if (noMachines == 0) {
+                return 0;
+            }
+
+            return std::max(ceilDivide(duration, noMachines), ceilDivide(size, power));
+        };
+
+        // All machines, then the smallest sets, which are the most likely to be crowded
+        long long totalDuration = 0;
+        long long totalSize = 0;
+        for (const auto &set : sets) {
+            totalDuration += set.duration;
+            totalSize += set.size;
+        }
+
+        long long totalPower = 0;
+        for (int machine = 0; machine < instance.noMachines(); machine++) {
+            totalPower += instance.machines[machine].power;
+        }
+
+        affinityLoad = boundOf(totalDuration, totalSize, instance.noMachines(), totalPower);
+
+        std::vector<int> candidates(sets.size());
+        std::iota(candidates.begin(), candidates.end(), 0);
+        std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+            return sets[a].noMachines < sets[b].noMachines;
+        });
+
+        candidates.resize(std::min<std::size_t>(candidates.size(), maxCandidateSets));
+
+        for (int c : candidates) {
+            const auto &candidate = sets[c];
+
+            long long duration = 0;
+            long long size = 0;
+
+            for (const auto &set : sets) {
+                if (set.noMachines > candidate.noMachines) {
+                    continue;
+                }
+
+                bool subset = true;
+                for (int w = 0; w < noWords && subset; w++) {
+                    subset = (set.words[w] & ~candidate.words[w]) == 0;
+                }
+
+                if (subset) {
+                    duration += set.duration;
+                    size += set.size;
+                }
+            }
+
+            affinityLoad = std::max(affinityLoad, boundOf(duration, size, candidate.noMachines, candidate.power));
+        }
+    }
+
+    // Reading and writing a task's data costs the number of times it is read or written per unit of data over the speed
+    // of its disk. The cheapest fractional assignment gives the most used data to the fastest disks until they are full.
+    void setDiskTraffic(const Instance &instance, const std::vector<int> &minRunTime) {
+        int n = instance.noTasks();
+
+        std::vector<int> tasks(n);
+        std::iota(tasks.begin(), tasks.end(), 0);
+        std::sort(tasks.begin(), tasks.end(), [&](int a, int b) {
+            return instance.dataDependentsOf(a).size() > instance.dataDependentsOf(b).size();
+        });
+
+        std::vector<int> disks(instance.noDisks());
+        std::iota(disks.begin(), disks.end(), 0);
+        std::sort(disks.begin(), disks.end(), [&](int a, int b) {
+            return instance.disks[a].speed > instance.disks[b].speed;
+        });
+
+        double trafficTime = 0;
+
+        std::size_t disk = 0;
+        long long freeCapacity = disks.empty() ? 0 : instance.disks[disks[0]].capacity;
+
+        for (int i : tasks) {
+            long long data = instance.tasks[i].dataSize;
+            auto traffic = (double) (instance.dataDependentsOf(i).size() + 1);
+
+            while (data > 0 && disk < disks.size()) {
+                long long amount = std::min(data, freeCapacity);
+                trafficTime += traffic * (double) amount / instance.disks[disks[disk]].speed;
+
+                data -= amount;
+                freeCapacity -= amount;
+
+                if (freeCapacity == 0 && ++disk < disks.size()) {
+                    freeCapacity = instance.disks[disks[disk]].capacity;
+                }
+            }
+        }
+
+        long long totalRunTime = std::accumulate(minRunTime.begin(), minRunTime.end(), 0ll);
+
+        if (instance.noMachines() > 0) {
+            diskTraffic = (int) std::ceil((totalRunTime + trafficTime) / instance.noMachines() - 1e-9);
+        }
+    }
+};
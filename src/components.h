@@ -0,0 +1,373 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "instance.h"
+#include "parallel.h"
+#include "reduction.h"
+
+// Weakly connected components of the task graph, over data and task dependencies alike.
+// Components are numbered by their lowest task index and list their tasks in ascending index order,
+// so anything computed per component is independent of how the work is split over threads.
+struct Components {
+    std::vector<int> componentOf;
+    std::vector<int> localIndex;
+    std::vector<int> offsets = {0};
+    std::vector<int> tasks;
+
+    Components() = default;
+
+    explicit Components(const Instance &instance) {
+        int n = instance.noTasks();
+
+        std::vector<int> parent(n);
+        std::iota(parent.begin(), parent.end(), 0);
+
+        std::vector<int> size(n, 1);
+
+        auto find = [&](int x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+
+            return x;
+        };
+
+        auto unite = [&](int a, int b) {
+            a = find(a);
+            b = find(b);
+
+            if (a == b) {
+                return;
+            }
+
+            if (size[a] < size[b]) {
+                std::swap(a, b);
+            }
+
+            parent[b] = a;
+            size[a] += size[b];
+        };
+
+        for (int i = 0; i < n; i++) {
+            for (int j : instance.dataDependentsOf(i)) {
+                unite(i, j);
+            }
+
+            for (int j : instance.taskDependentsOf(i)) {
+                unite(i, j);
+            }
+        }
+
+        componentOf.assign(n, -1);
+        std::vector<int> componentOfRoot(n, -1);
+
+        int noComponents = 0;
+        for (int i = 0; i < n; i++) {
+            int root = find(i);
+            if (componentOfRoot[root] == -1) {
+                componentOfRoot[root] = noComponents++;
+            }
+
+            componentOf[i] = componentOfRoot[root];
+        }
+
+        offsets.assign(noComponents + 1, 0);
+        for (int i = 0; i < n; i++) {
+            offsets[componentOf[i] + 1]++;
+        }
+
+        for (int i = 0; i < noComponents; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        tasks.resize(n);
+        localIndex.resize(n);
+
+        std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (int i = 0; i < n; i++) {
+            int position = cursor[componentOf[i]]++;
+            tasks[position] = i;
+            localIndex[i] = position - offsets[componentOf[i]];
+        }
+    }
+
+    [[nodiscard]] int size() const {
+        return (int) offsets.size() - 1;
+    }
+
+    [[nodiscard]] std::span<const int> tasksOf(int component) const {
+        return {tasks.data() + offsets[component], tasks.data() + offsets[component + 1]};
+    }
+};
+
+// Structure of a component: its dependents over data and task dependencies alike, with tasks numbered by their position
+// in the component, duplicates merged and every task's dependents sorted.
+// Everything that only depends on this structure is computed once per shape and shared by all components of that shape.
+struct Shape {
+    int noTasks = 0;
+
+    std::vector<std::int32_t> dependentOffsets;
+    std::vector<std::int32_t> dependents;
+
+    // Tasks by level in reverse topological order, a task's level is one more than the highest level of its dependents
+    std::vector<int> levelOffsets;
+    std::vector<int> levelTasks;
+
+    // Per edge, whether the dependent is also reachable through a path of two or more edges, empty if not computed
+    std::vector<std::uint8_t> implied;
+
+    Shape() = default;
+
+    Shape(const Instance &instance, const Components &components, int component) {
+        collectDependents(instance, components, component, dependentOffsets, dependents);
+        noTasks = (int) dependentOffsets.size() - 1;
+
+        setLevels();
+    }
+
+    [[nodiscard]] CsrGraph graph() const {
+        return {noTasks, dependentOffsets, dependents};
+    }
+
+    [[nodiscard]] int noLevels() const {
+        return (int) levelOffsets.size() - 1;
+    }
+
+    [[nodiscard]] bool isAcyclic() const {
+        return (int) levelTasks.size() == noTasks;
+    }
+
+    // Index of the edge from -> to, or -1 if the shape has no such edge
+    [[nodiscard]] int edgeIndex(int from, int to) const {
+        auto begin = dependents.begin() + dependentOffsets[from];
+        auto end = dependents.begin() + dependentOffsets[from + 1];
+
+        auto it = std::lower_bound(begin, end, to);
+        return it != end && *it == to ? (int) (it - dependents.begin()) : -1;
+    }
+
+    void setImplied() {
+        std::vector<std::int32_t> noOffsets(noTasks + 1);
+        implied = findRedundantEdges({noTasks, noOffsets, {}}, graph());
+    }
+
+    [[nodiscard]] std::uint64_t hash() const {
+        return hashDependents(dependentOffsets, dependents);
+    }
+
+    [[nodiscard]] bool matches(const std::vector<std::int32_t> &offsets, const std::vector<std::int32_t> &targets) const {
+        return offsets == dependentOffsets && targets == dependents;
+    }
+
+    static void collectDependents(const Instance &instance,
+                                  const Components &components,
+                                  int component,
+                                  std::vector<std::int32_t> &offsets,
+                                  std::vector<std::int32_t> &targets) {
+        auto componentTasks = components.tasksOf(component);
+
+        offsets.assign(1, 0);
+        offsets.reserve(componentTasks.size() + 1);
+        targets.clear();
+
+        for (int task : componentTasks) {
+            std::size_t begin = targets.size();
+
+            for (auto list : {instance.dataDependentsOf(task), instance.taskDependentsOf(task)}) {
+                for (int target : list) {
+                    targets.push_back(components.localIndex[target]);
+                }
+            }
+
+            std::sort(targets.begin() + begin, targets.end());
+            targets.erase(std::unique(targets.begin() + begin, targets.end()), targets.end());
+
+            offsets.push_back((std::int32_t) targets.size());
+        }
+    }
+
+    static std::uint64_t hashDependents(const std::vector<std::int32_t> &offsets, const std::vector<std::int32_t> &targets) {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+
+        auto mix = [&](std::uint64_t value) {
+            hash = (hash ^ value) * 0x100000001b3ull;
+            hash ^= hash >> 29;
+        };
+
+        mix(offsets.size());
+        for (std::int32_t offset : offsets) {
+            mix(offset);
+        }
+
+        for (std::int32_t target : targets) {
+            mix(target);
+        }
+
+        return hash;
+    }
+
+private:
+    void setLevels() {
+        std::vector<int> remainingDependents(noTasks);
+        std::vector<int> dependencyOffsets(noTasks + 1);
+
+        for (int i = 0; i < noTasks; i++) {
+            remainingDependents[i] = dependentOffsets[i + 1] - dependentOffsets[i];
+
+            for (int j = dependentOffsets[i]; j < dependentOffsets[i + 1]; j++) {
+                dependencyOffsets[dependents[j] + 1]++;
+            }
+        }
+
+        for (int i = 0; i < noTasks; i++) {
+            dependencyOffsets[i + 1] += dependencyOffsets[i];
+        }
+
+        std::vector<int> dependencies(dependents.size());
+        std::vector<int> cursor(dependencyOffsets.begin(), dependencyOffsets.end() - 1);
+        for (int i = 0; i < noTasks; i++) {
+            for (int j = dependentOffsets[i]; j < dependentOffsets[i + 1]; j++) {
+                dependencies[cursor[dependents[j]]++] = i;
+            }
+        }
+
+        std::vector<int> order;
+        order.reserve(noTasks);
+
+        for (int i = 0; i < noTasks; i++) {
+            if (remainingDependents[i] == 0) {
+                order.push_back(i);
+            }
+        }
+
+        std::vector<int> level(noTasks);
+
+        for (std::size_t k = 0; k < order.size(); k++) {
+            int i = order[k];
+
+            for (int j = dependencyOffsets[i]; j < dependencyOffsets[i + 1]; j++) {
+                int t = dependencies[j];
+                level[t] = std::max(level[t], level[i] + 1);
+
+                if (--remainingDependents[t] == 0) {
+                    order.push_back(t);
+                }
+            }
+        }
+
+        int levels = 0;
+        for (int i : order) {
+            levels = std::max(levels, level[i] + 1);
+        }
+
+        levelOffsets.assign(levels + 1, 0);
+        for (int i : order) {
+            levelOffsets[level[i] + 1]++;
+        }
+
+        for (int l = 0; l < levels; l++) {
+            levelOffsets[l + 1] += levelOffsets[l];
+        }
+
+        levelTasks.resize(order.size());
+        std::copy(levelOffsets.begin(), levelOffsets.end() - 1, cursor.begin());
+        for (int i : order) {
+            levelTasks[cursor[level[i]]++] = i;
+        }
+    }
+};
+
+// Groups components by shape. Candidates are found by hashing the shape of every component and confirmed by comparing
+// the shapes in full, tasks are matched by their position in the component, which is how replicated workflows are laid out.
+struct ComponentShapes {
+    std::vector<int> shapeOf;
+    std::vector<Shape> shapes;
+
+    ComponentShapes() = default;
+
+    ComponentShapes(const Instance &instance, const Components &components, ThreadPool &threadPool) {
+        int noComponents = components.size();
+
+        // A component can only share its shape with components of the same size, the others skip hashing
+        std::unordered_map<int, int> noComponentsOfSize;
+        for (int component = 0; component < noComponents; component++) {
+            noComponentsOfSize[(int) components.tasksOf(component).size()]++;
+        }
+
+        std::vector<std::uint64_t> hashes(noComponents);
+        std::vector<std::uint8_t> unique(noComponents);
+
+        threadPool.parallelFor(0, noComponents, [&](int component) {
+            if (noComponentsOfSize.at((int) components.tasksOf(component).size()) == 1) {
+                unique[component] = 1;
+                return;
+            }
+
+            std::vector<std::int32_t> offsets;
+            std::vector<std::int32_t> targets;
+            Shape::collectDependents(instance, components, component, offsets, targets);
+
+            hashes[component] = Shape::hashDependents(offsets, targets);
+        }, 1);
+
+        std::vector<int> representatives;
+        std::unordered_map<std::uint64_t, int> shapeOfHash;
+
+        shapeOf.resize(noComponents);
+        for (int component = 0; component < noComponents; component++) {
+            if (unique[component]) {
+                shapeOf[component] = (int) representatives.size();
+                representatives.push_back(component);
+                continue;
+            }
+
+            auto [it, inserted] = shapeOfHash.try_emplace(hashes[component], (int) representatives.size());
+            if (inserted) {
+                representatives.push_back(component);
+            }
+
+            shapeOf[component] = it->second;
+        }
+
+        shapes.resize(representatives.size());
+        threadPool.parallelFor(0, (int) representatives.size(), [&](int shape) {
+            shapes[shape] = Shape(instance, components, representatives[shape]);
+        }, 1);
+
+        std::vector<std::uint8_t> collided(noComponents);
+        threadPool.parallelFor(0, noComponents, [&](int component) {
+            if (representatives[shapeOf[component]] == component) {
+                return;
+            }
+
+            std::vector<std::int32_t> offsets;
+            std::vector<std::int32_t> targets;
+            Shape::collectDependents(instance, components, component, offsets, targets);
+
+            collided[component] = !shapes[shapeOf[component]].matches(offsets, targets);
+        }, 1);
+
+        for (int component = 0; component < noComponents; component++) {
+            if (collided[component]) {
+                shapeOf[component] = (int) shapes.size();
+                shapes.emplace_back(instance, components, component);
+            }
+        }
+    }
+
+    [[nodiscard]] int size() const {
+        return (int) shapes.size();
+    }
+
+    [[nodiscard]] const Shape &shapeOfComponent(int component) const {
+        return shapes[shapeOf[component]];
+    }
+};
@@ -0,0 +1,43 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "instance.h"
+
+// Converts an instance between the text and binary formats.
+// The output is written in text format if its path ends in ".in" and in binary format otherwise.
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input> <output>" << std::endl;
+        return 1;
+    }
+
+    std::string inputPath = argv[1];
+    std::string outputPath = argv[2];
+
+    try {
+        Instance instance;
+        instance.load(inputPath);
+
+        std::ofstream out(outputPath, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Cannot open " + outputPath);
+        }
+
+        if (outputPath.ends_with(".in")) {
+            instance.writeText(out);
+        } else {
+            instance.writeBinary(out);
+        }
+
+        if (!out.flush()) {
+            throw std::runtime_error("Cannot write " + outputPath);
+        }
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
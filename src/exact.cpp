@@ -0,0 +1,933 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "arguments.h"
+#include "bounds.h"
+#include "instance.h"
+#include "parallel.h"
+#include "timeline.h"
+
+// Exact branch-and-bound for small instances, a reference for how far the heuristics are from optimal.
+// Tasks are placed one at a time in every order that respects the dependencies, on every machine and disk they can use,
+// at the earliest time the machine is free (serial schedule generation). Placing the tasks of an optimal schedule in
+// order of their start times like this starts none of them later, so some order yields an optimal schedule.
+// A node is pruned if a lower bound on its makespan reaches the best makespan found so far, or if a node with the same
+// remaining subproblem and no larger makespan was visited before. The subtrees below the root are searched in parallel.
+// A schedule given with --initial, such as a heuristic's output, sets the first upper bound.
+// The best schedule is written to stdout, whether it is proven optimal to stderr.
+struct ExactSolver {
+    static constexpr int maxTasks = 64;
+    static constexpr std::size_t maxMemoEntries = 1 << 21;
+
+    int noTasks = 0;
+    int noMachines = 0;
+    int noDisks = 0;
+
+    std::vector<int> dataSize;
+    std::vector<int> capacity;
+
+    // Run time of every task on every machine, -1 if the task has no affinity for it
+    std::vector<int> runTime;
+    std::vector<std::vector<int>> allowedMachines;
+
+    // Write time of every task on every disk, and the lowest one on a disk large enough for its data
+    std::vector<int> writeTime;
+    std::vector<int> minWriteTime;
+
+    // Tasks with an affinity for every machine, as bitmasks over task indices
+    std::vector<std::uint64_t> affinityMaskOf;
+
+    std::vector<std::vector<int>> dataDependencies;
+    std::vector<std::vector<int>> taskDependencies;
+    std::vector<std::vector<int>> dataDependents;
+    std::vector<std::vector<int>> taskDependents;
+    std::vector<std::vector<int>> dependents;
+    std::vector<int> noDependencies;
+
+    std::vector<int> topologicalOrder;
+
+    // Lower bounds on the duration of a task and on the time from its start to the makespan
+    std::vector<int> minDuration;
+    std::vector<int> tail;
+
+    // Lower bound on the makespan of the whole instance, no node can end below it
+    int instanceBound = 0;
+
+    // Machines of equal power, and disks of equal speed and capacity
+    std::vector<int> machineClassOf;
+    std::vector<int> diskClassOf;
+
+    std::atomic<int> upperBound = std::numeric_limits<int>::max();
+    std::atomic<bool> aborted = false;
+    std::atomic<std::size_t> noNodes = 0;
+
+    std::mutex bestMutex;
+    std::vector<int> bestStartTime;
+    std::vector<int> bestMachine;
+    std::vector<int> bestDisk;
+
+    std::chrono::steady_clock::time_point deadline;
+
+    struct MemoKey {
+        std::uint64_t a = 0;
+        std::uint64_t b = 0;
+
+        bool operator==(const MemoKey &other) const {
+            return a == other.a && b == other.b;
+        }
+    };
+
+    struct MemoKeyHash {
+        std::size_t operator()(const MemoKey &key) const {
+            return key.a;
+        }
+    };
+
+    // Lowest makespan at which every remaining subproblem was visited, sharded to keep threads from contending
+    struct MemoShard {
+        std::mutex mutex;
+        std::unordered_map<MemoKey, int, MemoKeyHash> makespanOf;
+    };
+
+    static constexpr int noMemoShards = 64;
+    std::vector<MemoShard> memo = std::vector<MemoShard>(noMemoShards);
+    std::atomic<std::size_t> noMemoEntries = 0;
+
+    struct Option {
+        int task = 0;
+        int machine = 0;
+        int disk = 0;
+        int startTime = 0;
+        int endTime = 0;
+        int lowerBound = 0;
+    };
+
+    // State of one thread's depth-first search, every placement is undone on the way back up
+    struct Search {
+        Arena arena;
+        std::vector<Timeline> timelines;
+
+        std::vector<int> startTime;
+        std::vector<int> machineOf;
+        std::vector<int> diskOf;
+        std::vector<int> endRunTime;
+        std::vector<int> endWriteTime;
+        std::vector<int> usedCapacity;
+        std::vector<int> remainingDependencies;
+
+        std::uint64_t scheduled = 0;
+        int makespan = 0;
+
+        std::vector<int> heads;
+        std::vector<std::vector<Option>> options;
+        std::vector<std::uint64_t> words;
+
+        explicit Search(const ExactSolver &solver)
+            : startTime(solver.noTasks),
+              machineOf(solver.noTasks, -1),
+              diskOf(solver.noTasks, -1),
+              endRunTime(solver.noTasks),
+              endWriteTime(solver.noTasks),
+              usedCapacity(solver.noDisks),
+              remainingDependencies(solver.noDependencies),
+              heads(solver.noTasks),
+              options(solver.noTasks + 1) {
+            for (int i = 0; i < solver.noMachines; i++) {
+                timelines.emplace_back(arena, TimelineEngine::Intervals);
+            }
+        }
+    };
+
+    explicit ExactSolver(const Instance &instance) {
+        noTasks = instance.noTasks();
+        noMachines = instance.noMachines();
+        noDisks = instance.noDisks();
+
+        if (noTasks > maxTasks) {
+            throw std::runtime_error("The exact solver supports up to " + std::to_string(maxTasks) + " tasks, got "
+                                     + std::to_string(noTasks));
+        }
+
+        dataSize.resize(noTasks);
+        runTime.assign(noTasks * noMachines, -1);
+        allowedMachines.resize(noTasks);
+        affinityMaskOf.assign(noMachines, 0);
+        writeTime.resize(noTasks * noDisks);
+        minWriteTime.assign(noTasks, std::numeric_limits<int>::max());
+
+        for (int i = 0; i < noTasks; i++) {
+            dataSize[i] = instance.tasks[i].dataSize;
+
+            for (int machine : instance.affinitiesOf(i)) {
+                runTime[i * noMachines + machine] = (int) std::ceil((double) instance.tasks[i].taskSize
+                                                                    / (double) instance.machines[machine].power);
+                allowedMachines[i].push_back(machine);
+                affinityMaskOf[machine] |= 1ull << i;
+            }
+
+            for (int disk = 0; disk < noDisks; disk++) {
+                writeTime[i * noDisks + disk] = (int) std::ceil((double) dataSize[i] / (double) instance.disks[disk].speed);
+                if (dataSize[i] <= instance.disks[disk].capacity) {
+                    minWriteTime[i] = std::min(minWriteTime[i], writeTime[i * noDisks + disk]);
+                }
+            }
+
+            if (minWriteTime[i] == std::numeric_limits<int>::max()) {
+                throw std::runtime_error("No disk can hold the data of task " + std::to_string(instance.tasks[i].id));
+            }
+        }
+
+        capacity.resize(noDisks);
+        for (int disk = 0; disk < noDisks; disk++) {
+            capacity[disk] = instance.disks[disk].capacity;
+        }
+
+        dataDependencies.resize(noTasks);
+        taskDependencies.resize(noTasks);
+        dataDependents.resize(noTasks);
+        taskDependents.resize(noTasks);
+        dependents.resize(noTasks);
+        noDependencies.assign(noTasks, 0);
+
+        for (int i = 0; i < noTasks; i++) {
+            dataDependencies[i].assign(instance.dataDependenciesOf(i).begin(), instance.dataDependenciesOf(i).end());
+            taskDependencies[i].assign(instance.taskDependenciesOf(i).begin(), instance.taskDependenciesOf(i).end());
+            dataDependents[i].assign(instance.dataDependentsOf(i).begin(), instance.dataDependentsOf(i).end());
+            taskDependents[i].assign(instance.taskDependentsOf(i).begin(), instance.taskDependentsOf(i).end());
+
+            dependents[i] = dataDependents[i];
+            dependents[i].insert(dependents[i].end(), taskDependents[i].begin(), taskDependents[i].end());
+            std::sort(dependents[i].begin(), dependents[i].end());
+            dependents[i].erase(std::unique(dependents[i].begin(), dependents[i].end()), dependents[i].end());
+        }
+
+        for (int i = 0; i < noTasks; i++) {
+            for (int j : dependents[i]) {
+                noDependencies[j]++;
+            }
+        }
+
+        setTopologicalOrder();
+        setTails();
+        setClasses(instance);
+
+        instanceBound = LowerBounds(instance).value();
+    }
+
+    // Searches until the time limit and returns whether the best schedule is proven optimal
+    bool solve(ThreadPool &threadPool, double timeLimit) {
+        deadline = std::chrono::steady_clock::now()
+                   + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeLimit));
+
+        if (upperBound.load() <= instanceBound) {
+            std::cerr << "Initial schedule meets the lower bound " << instanceBound << std::endl;
+            return true;
+        }
+
+        Search root(*this);
+        int rootBound = expand(root, 0);
+
+        if (upperBound.load() < rootBound) {
+            throw std::runtime_error("The initial makespan " + std::to_string(upperBound.load())
+                                     + " is below the root lower bound " + std::to_string(rootBound));
+        }
+
+        std::vector<Option> rootOptions = root.options[0];
+        std::atomic<int> next = 0;
+
+        threadPool.parallelFor(0, threadPool.size(), [&](int) {
+            Search search(*this);
+
+            for (int i = next.fetch_add(1); i < (int) rootOptions.size(); i = next.fetch_add(1)) {
+                const Option &option = rootOptions[i];
+                if (option.lowerBound >= upperBound.load()) {
+                    continue;
+                }
+
+                place(search, option);
+                dfs(search, 1);
+                unplace(search, option, 0);
+            }
+        }, 1);
+
+        std::cerr << "Searched " << noNodes.load() << " nodes, root lower bound " << rootBound << std::endl;
+
+        return !aborted.load();
+    }
+
+    // Starts from a known schedule in the solver output format. It is replayed through the search's own placement:
+    // tasks go in order of their start times among the ones whose dependencies are placed, on their machine and disk,
+    // at the earliest time the machine is free. A feasible schedule comes out with no task starting later, an
+    // infeasible one comes out repaired. The makespan of the replay becomes the upper bound to beat.
+    void setInitialSchedule(const Instance &instance, std::istream &in) {
+        std::unordered_map<int, int> taskOfId;
+        std::unordered_map<int, int> machineOfId;
+        std::unordered_map<int, int> diskOfId;
+
+        for (int i = 0; i < noTasks; i++) {
+            taskOfId[instance.tasks[i].id] = i;
+        }
+
+        for (int i = 0; i < noMachines; i++) {
+            machineOfId[instance.machines[i].id] = i;
+        }
+
+        for (int i = 0; i < noDisks; i++) {
+            diskOfId[instance.disks[i].id] = i;
+        }
+
+        auto indexOf = [](const std::unordered_map<int, int> &indexOfId, int id, const char *kind) {
+            auto it = indexOfId.find(id);
+            if (it == indexOfId.end()) {
+                throw std::runtime_error(std::string("The initial schedule has unknown ") + kind + " "
+                                         + std::to_string(id));
+            }
+
+            return it->second;
+        };
+
+        std::vector<int> startTime(noTasks, -1);
+        std::vector<int> machineOf(noTasks, -1);
+        std::vector<int> diskOf(noTasks, -1);
+
+        int id, start, machineId, diskId;
+        while (in >> id >> start >> machineId >> diskId) {
+            int i = indexOf(taskOfId, id, "task");
+
+            startTime[i] = start;
+            machineOf[i] = indexOf(machineOfId, machineId, "machine");
+            diskOf[i] = indexOf(diskOfId, diskId, "disk");
+        }
+
+        for (int i = 0; i < noTasks; i++) {
+            if (startTime[i] < 0 || runTime[i * noMachines + machineOf[i]] == -1) {
+                throw std::runtime_error("The initial schedule does not place task " + std::to_string(instance.tasks[i].id)
+                                         + " on a machine it has an affinity for");
+            }
+        }
+
+        Search search(*this);
+        int noShifted = 0;
+
+        for (int depth = 0; depth < noTasks; depth++) {
+            int next = -1;
+            for (int i = 0; i < noTasks; i++) {
+                if (!isScheduled(search, i) && search.remainingDependencies[i] == 0
+                    && (next == -1 || startTime[i] < startTime[next])) {
+                    next = i;
+                }
+            }
+
+            if (search.usedCapacity[diskOf[next]] + dataSize[next] > capacity[diskOf[next]]) {
+                throw std::runtime_error("The initial schedule overfills disk "
+                                         + std::to_string(instance.disks[diskOf[next]].id));
+            }
+
+            int minStartTime = 0;
+            for (int d : dataDependencies[next]) {
+                minStartTime = std::max(minStartTime, search.endWriteTime[d]);
+            }
+
+            for (int d : taskDependencies[next]) {
+                minStartTime = std::max(minStartTime, search.endRunTime[d]);
+            }
+
+            int duration = readTimeOf(search, next) + runTime[next * noMachines + machineOf[next]]
+                           + writeTime[next * noDisks + diskOf[next]];
+
+            Option option;
+            option.task = next;
+            option.machine = machineOf[next];
+            option.disk = diskOf[next];
+            option.startTime = search.timelines[option.machine].earliestFit(minStartTime, duration);
+            option.endTime = option.startTime + duration;
+
+            if (option.startTime > startTime[next]) {
+                noShifted++;
+            }
+
+            place(search, option);
+        }
+
+        // The replay is feasible, so a makespan below the lower bound can only be a bug in one of the two
+        if (search.makespan < instanceBound) {
+            throw std::runtime_error("The initial makespan " + std::to_string(search.makespan)
+                                     + " is below the lower bound " + std::to_string(instanceBound));
+        }
+
+        upperBound = search.makespan;
+
+        bestStartTime = search.startTime;
+        bestMachine = search.machineOf;
+        bestDisk = search.diskOf;
+
+        std::cerr << "Initial makespan " << search.makespan;
+        if (noShifted > 0) {
+            std::cerr << ", " << noShifted << " task(s) of the initial schedule had to start later";
+        }
+        std::cerr << std::endl;
+    }
+
+    [[nodiscard]] bool hasSchedule() const {
+        return !bestStartTime.empty();
+    }
+
+    void write(const Instance &instance, std::ostream &out) const {
+        for (int i = 0; i < noTasks; i++) {
+            out << instance.tasks[i].id
+                << " " << bestStartTime[i]
+                << " " << instance.machines[bestMachine[i]].id
+                << " " << instance.disks[bestDisk[i]].id
+                << "\n";
+        }
+    }
+
+private:
+    void setTopologicalOrder() {
+        std::vector<int> remaining = noDependencies;
+
+        for (int i = 0; i < noTasks; i++) {
+            if (remaining[i] == 0) {
+                topologicalOrder.push_back(i);
+            }
+        }
+
+        for (std::size_t k = 0; k < topologicalOrder.size(); k++) {
+            for (int j : dependents[topologicalOrder[k]]) {
+                if (--remaining[j] == 0) {
+                    topologicalOrder.push_back(j);
+                }
+            }
+        }
+
+        if ((int) topologicalOrder.size() != noTasks) {
+            throw std::runtime_error("The dependencies contain a cycle");
+        }
+    }
+
+    void setTails() {
+        minDuration.resize(noTasks);
+        for (int i = 0; i < noTasks; i++) {
+            int minRunTime = std::numeric_limits<int>::max();
+            for (int machine : allowedMachines[i]) {
+                minRunTime = std::min(minRunTime, runTime[i * noMachines + machine]);
+            }
+
+            int minReadTime = 0;
+            for (int d : dataDependencies[i]) {
+                minReadTime += minWriteTime[d];
+            }
+
+            minDuration[i] = minReadTime + minRunTime + minWriteTime[i];
+        }
+
+        tail.resize(noTasks);
+        for (auto it = topologicalOrder.rbegin(); it != topologicalOrder.rend(); it++) {
+            int i = *it;
+
+            tail[i] = minDuration[i];
+            for (int j : dataDependents[i]) {
+                tail[i] = std::max(tail[i], minDuration[i] + tail[j]);
+            }
+
+            for (int j : taskDependents[i]) {
+                tail[i] = std::max(tail[i], minDuration[i] - minWriteTime[i] + tail[j]);
+            }
+        }
+    }
+
+    void setClasses(const Instance &instance) {
+        machineClassOf.resize(noMachines);
+        for (int machine = 0; machine < noMachines; machine++) {
+            machineClassOf[machine] = machine;
+
+            for (int other = 0; other < machine; other++) {
+                if (instance.machines[other].power == instance.machines[machine].power) {
+                    machineClassOf[machine] = machineClassOf[other];
+                    break;
+                }
+            }
+        }
+
+        diskClassOf.resize(noDisks);
+        for (int disk = 0; disk < noDisks; disk++) {
+            diskClassOf[disk] = disk;
+
+            for (int other = 0; other < disk; other++) {
+                if (instance.disks[other].speed == instance.disks[disk].speed && capacity[other] == capacity[disk]) {
+                    diskClassOf[disk] = diskClassOf[other];
+                    break;
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool isScheduled(const Search &search, int task) const {
+        return (search.scheduled >> task & 1) != 0;
+    }
+
+    [[nodiscard]] int readTimeOf(const Search &search, int task) const {
+        int readTime = 0;
+        for (int d : dataDependencies[task]) {
+            readTime += writeTime[d * noDisks + search.diskOf[d]];
+        }
+
+        return readTime;
+    }
+
+    // Earliest start of every unscheduled task given the placed tasks, with unplaced dependencies at their shortest
+    // and the task at its shortest on the machine that is free first. Returns a lower bound on the makespan,
+    // which is infinite if some task's data no longer fits on any disk.
+    int setHeads(Search &search) const {
+        int lowerBound = std::max(search.makespan, instanceBound);
+
+        for (int i : topologicalOrder) {
+            if (isScheduled(search, i)) {
+                continue;
+            }
+
+            int minStartTime = 0;
+            int readTime = 0;
+
+            for (int d : dataDependencies[i]) {
+                if (isScheduled(search, d)) {
+                    minStartTime = std::max(minStartTime, search.endWriteTime[d]);
+                    readTime += writeTime[d * noDisks + search.diskOf[d]];
+                } else {
+                    minStartTime = std::max(minStartTime, search.heads[d] + minDuration[d]);
+                    readTime += minWriteTime[d];
+                }
+            }
+
+            for (int d : taskDependencies[i]) {
+                if (isScheduled(search, d)) {
+                    minStartTime = std::max(minStartTime, search.endRunTime[d]);
+                } else {
+                    minStartTime = std::max(minStartTime, search.heads[d] + minDuration[d] - minWriteTime[d]);
+                }
+            }
+
+            int minWrite = std::numeric_limits<int>::max();
+            for (int disk = 0; disk < noDisks; disk++) {
+                if (search.usedCapacity[disk] + dataSize[i] <= capacity[disk]) {
+                    minWrite = std::min(minWrite, writeTime[i * noDisks + disk]);
+                }
+            }
+
+            if (minWrite == std::numeric_limits<int>::max()) {
+                return std::numeric_limits<int>::max();
+            }
+
+            int head = std::numeric_limits<int>::max();
+            int minDurationNow = std::numeric_limits<int>::max();
+            for (int machine : allowedMachines[i]) {
+                int duration = readTime + runTime[i * noMachines + machine] + minWrite;
+                head = std::min(head, search.timelines[machine].earliestFit(minStartTime, duration));
+                minDurationNow = std::min(minDurationNow, duration);
+            }
+
+            search.heads[i] = head;
+            lowerBound = std::max(lowerBound, head + std::max(tail[i], minDurationNow));
+        }
+
+        return lowerBound;
+    }
+
+    // Key of the subproblem that remains: which tasks are placed, the free time of every machine from the earliest
+    // start of any unscheduled task on, the end and write times of placed tasks that still have unplaced dependents
+    // and the capacity left on every disk. Equivalent machines and disks are compared as sorted groups.
+    MemoKey keyOf(Search &search) const {
+        int minHead = std::numeric_limits<int>::max();
+        for (int i = 0; i < noTasks; i++) {
+            if (!isScheduled(search, i)) {
+                minHead = std::min(minHead, search.heads[i]);
+            }
+        }
+
+        auto &words = search.words;
+        words.clear();
+        words.push_back(search.scheduled);
+
+        std::vector<std::pair<int, std::uint64_t>> machineHashes;
+        for (int machine = 0; machine < noMachines; machine++) {
+            std::uint64_t hash = 0x9e3779b97f4a7c15ull;
+            for (const auto &[start, end] : search.timelines[machine].intervals.availableIntervals) {
+                if (end > minHead) {
+                    hash = mix(hash, ((std::uint64_t) std::max(start, minHead) << 32) | (std::uint32_t) end);
+                }
+            }
+
+            hash = mix(hash, affinityMaskOf[machine] & ~search.scheduled);
+            machineHashes.emplace_back(machineClassOf[machine], hash);
+        }
+
+        std::sort(machineHashes.begin(), machineHashes.end());
+        for (const auto &[machineClass, hash] : machineHashes) {
+            words.push_back(hash);
+        }
+
+        for (int i = 0; i < noTasks; i++) {
+            if (!isScheduled(search, i)) {
+                continue;
+            }
+
+            bool frontier = std::any_of(dependents[i].begin(), dependents[i].end(), [&](int j) {
+                return !isScheduled(search, j);
+            });
+
+            if (frontier) {
+                words.push_back(((std::uint64_t) i << 32) | (std::uint32_t) search.endWriteTime[i]);
+                words.push_back(((std::uint64_t) search.endRunTime[i] << 32)
+                                | (std::uint32_t) writeTime[i * noDisks + search.diskOf[i]]);
+            }
+        }
+
+        std::vector<std::pair<int, int>> disks;
+        for (int disk = 0; disk < noDisks; disk++) {
+            disks.emplace_back(diskClassOf[disk], search.usedCapacity[disk]);
+        }
+
+        std::sort(disks.begin(), disks.end());
+        for (const auto &[diskClass, usedCapacity] : disks) {
+            words.push_back(((std::uint64_t) diskClass << 32) | (std::uint32_t) usedCapacity);
+        }
+
+        MemoKey key{0xcbf29ce484222325ull, 0x84222325cbf29ce4ull};
+        for (std::uint64_t word : words) {
+            key.a = mix(key.a, word);
+            key.b = mix(key.b ^ 0x5851f42d4c957f2dull, word);
+        }
+
+        return key;
+    }
+
+    static std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        hash ^= hash >> 31;
+        hash *= 0xbf58476d1ce4e5b9ull;
+        hash ^= hash >> 29;
+        return hash;
+    }
+
+    // Returns false if a node with the same subproblem and no larger makespan was visited before
+    bool visit(Search &search) {
+        MemoKey key = keyOf(search);
+        MemoShard &shard = memo[key.b % noMemoShards];
+
+        std::lock_guard lock(shard.mutex);
+
+        auto it = shard.makespanOf.find(key);
+        if (it != shard.makespanOf.end()) {
+            if (it->second <= search.makespan) {
+                return false;
+            }
+
+            it->second = search.makespan;
+            return true;
+        }
+
+        if (noMemoEntries.load(std::memory_order_relaxed) < maxMemoEntries) {
+            shard.makespanOf.emplace(key, search.makespan);
+            noMemoEntries++;
+        }
+
+        return true;
+    }
+
+    // Collects the options of every ready task into search.options[depth], best lower bound first, and returns the
+    // lower bound of the node. Disks that give the task the same write time and leave the same capacity are
+    // interchangeable, as are equivalent machines with the same free time.
+    int expand(Search &search, int depth) {
+        int lowerBound = setHeads(search);
+
+        auto &options = search.options[depth];
+        options.clear();
+
+        if (lowerBound >= upperBound.load()) {
+            return lowerBound;
+        }
+
+        int remainingDataSize = 0;
+        for (int i = 0; i < noTasks; i++) {
+            if (!isScheduled(search, i)) {
+                remainingDataSize += dataSize[i];
+            }
+        }
+
+        std::vector<std::tuple<int, int, int>> diskVariants;
+        std::vector<int> disks;
+
+        for (int i = 0; i < noTasks; i++) {
+            if (isScheduled(search, i) || search.remainingDependencies[i] != 0) {
+                continue;
+            }
+
+            int minStartTime = 0;
+            for (int d : dataDependencies[i]) {
+                minStartTime = std::max(minStartTime, search.endWriteTime[d]);
+            }
+
+            for (int d : taskDependencies[i]) {
+                minStartTime = std::max(minStartTime, search.endRunTime[d]);
+            }
+
+            int readTime = readTimeOf(search, i);
+
+            // A disk that can hold all remaining data can take the task in any completion, so the fastest such disk
+            // is at least as good as any other disk that is not faster, only faster disks that may fill up are tried too
+            int unconstrainedWrite = std::numeric_limits<int>::max();
+            for (int disk = 0; disk < noDisks; disk++) {
+                if (search.usedCapacity[disk] + remainingDataSize <= capacity[disk]) {
+                    unconstrainedWrite = std::min(unconstrainedWrite, writeTime[i * noDisks + disk]);
+                }
+            }
+
+            diskVariants.clear();
+            disks.clear();
+            for (int disk = 0; disk < noDisks; disk++) {
+                int write = writeTime[i * noDisks + disk];
+                bool unconstrained = search.usedCapacity[disk] + remainingDataSize <= capacity[disk];
+
+                if (search.usedCapacity[disk] + dataSize[i] > capacity[disk]
+                    || write > unconstrainedWrite
+                    || (write == unconstrainedWrite && !unconstrained)) {
+                    continue;
+                }
+
+                // Constrained disks are only interchangeable within a class, another speed changes the write times of
+                // the later tasks that use the capacity left
+                std::tuple<int, int, int> variant(write, unconstrained ? -1 : diskClassOf[disk],
+                                                  unconstrained ? -1 : capacity[disk] - search.usedCapacity[disk]);
+                if (std::find(diskVariants.begin(), diskVariants.end(), variant) == diskVariants.end()) {
+                    diskVariants.push_back(variant);
+                    disks.push_back(disk);
+                }
+            }
+
+            // Machines of equal power with the same free time that the other remaining tasks can use alike are
+            // interchangeable
+            std::uint64_t others = ~search.scheduled & ~(1ull << i);
+
+            for (int machine : allowedMachines[i]) {
+                bool symmetric = false;
+                for (int other : allowedMachines[i]) {
+                    if (other >= machine) {
+                        break;
+                    }
+
+                    if (machineClassOf[other] == machineClassOf[machine]
+                        && (affinityMaskOf[other] & others) == (affinityMaskOf[machine] & others)
+                        && search.timelines[other].intervals.availableIntervals
+                           == search.timelines[machine].intervals.availableIntervals) {
+                        symmetric = true;
+                        break;
+                    }
+                }
+
+                if (symmetric) {
+                    continue;
+                }
+
+                for (int disk : disks) {
+                    int write = writeTime[i * noDisks + disk];
+                    int duration = readTime + runTime[i * noMachines + machine] + write;
+
+                    Option option;
+                    option.task = i;
+                    option.machine = machine;
+                    option.disk = disk;
+                    option.startTime = search.timelines[machine].earliestFit(minStartTime, duration);
+                    option.endTime = option.startTime + duration;
+
+                    option.lowerBound = std::max(lowerBound, option.endTime);
+                    for (int j : dataDependents[i]) {
+                        option.lowerBound = std::max(option.lowerBound, option.endTime + tail[j]);
+                    }
+
+                    for (int j : taskDependents[i]) {
+                        option.lowerBound = std::max(option.lowerBound, option.endTime - write + tail[j]);
+                    }
+
+                    if (option.lowerBound < upperBound.load()) {
+                        options.push_back(option);
+                    }
+                }
+            }
+        }
+
+        std::sort(options.begin(), options.end(), [](const Option &a, const Option &b) {
+            if (a.lowerBound != b.lowerBound) {
+                return a.lowerBound < b.lowerBound;
+            }
+
+            return a.endTime < b.endTime;
+        });
+
+        return lowerBound;
+    }
+
+    void dfs(Search &search, int depth) {
+        if (noNodes.fetch_add(1, std::memory_order_relaxed) % 1024 == 0
+            && std::chrono::steady_clock::now() >= deadline) {
+            aborted = true;
+        }
+
+        if (aborted.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        if (depth == noTasks) {
+            record(search);
+            return;
+        }
+
+        expand(search, depth);
+        if (search.options[depth].empty() || !visit(search)) {
+            return;
+        }
+
+        for (std::size_t k = 0; k < search.options[depth].size(); k++) {
+            Option option = search.options[depth][k];
+            if (option.lowerBound >= upperBound.load()) {
+                break;
+            }
+
+            int makespan = search.makespan;
+
+            place(search, option);
+            dfs(search, depth + 1);
+            unplace(search, option, makespan);
+        }
+    }
+
+    void place(Search &search, const Option &option) const {
+        int i = option.task;
+
+        search.startTime[i] = option.startTime;
+        search.machineOf[i] = option.machine;
+        search.diskOf[i] = option.disk;
+        search.endWriteTime[i] = option.endTime;
+        search.endRunTime[i] = option.endTime - writeTime[i * noDisks + option.disk];
+
+        search.timelines[option.machine].reserve(option.startTime, option.endTime);
+        search.usedCapacity[option.disk] += dataSize[i];
+        search.scheduled |= 1ull << i;
+
+        for (int j : dependents[i]) {
+            search.remainingDependencies[j]--;
+        }
+
+        search.makespan = std::max(search.makespan, option.endTime);
+    }
+
+    void unplace(Search &search, const Option &option, int previousMakespan) const {
+        int i = option.task;
+
+        for (int j : dependents[i]) {
+            search.remainingDependencies[j]++;
+        }
+
+        search.scheduled &= ~(1ull << i);
+        search.usedCapacity[option.disk] -= dataSize[i];
+        search.timelines[option.machine].release(option.startTime, option.endTime);
+
+        search.makespan = previousMakespan;
+    }
+
+    void record(const Search &search) {
+        std::lock_guard lock(bestMutex);
+
+        if (search.makespan >= upperBound.load()) {
+            return;
+        }
+
+        upperBound = search.makespan;
+
+        bestStartTime = search.startTime;
+        bestMachine = search.machineOf;
+        bestDisk = search.diskOf;
+    }
+};
+
+int main(int argc, char *argv[]) {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    double timeLimit = 60;
+    std::string initialPath;
+    int noThreads = ThreadPool::defaultSize();
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            std::string value = arg.substr(arg.find('=') + 1);
+
+            if (arg.starts_with("--time-limit=")) {
+                timeLimit = parseDouble(arg, value);
+                if (timeLimit <= 0) {
+                    throw std::invalid_argument("Invalid value in " + arg);
+                }
+            } else if (arg.starts_with("--initial=")) {
+                initialPath = value;
+            } else if (arg.starts_with("--threads=")) {
+                noThreads = parseInt(arg, value, 1);
+            } else {
+                throw std::invalid_argument("Unknown argument " + arg);
+            }
+        }
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    try {
+        Instance instance;
+        instance.load(STDIN_FILENO);
+
+        ExactSolver solver(instance);
+
+        if (!initialPath.empty()) {
+            std::ifstream in(initialPath);
+            if (!in) {
+                throw std::runtime_error("Cannot open " + initialPath);
+            }
+
+            solver.setInitialSchedule(instance, in);
+        }
+
+        ThreadPool threadPool(noThreads);
+
+        auto start = std::chrono::steady_clock::now();
+        bool optimal = solver.solve(threadPool, timeLimit);
+        auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        if (!solver.hasSchedule()) {
+            std::cerr << "No schedule found within " << duration.count() << " s" << std::endl;
+            return 1;
+        }
+
+        std::cerr << (optimal ? "Optimal" : "Best") << " makespan " << solver.upperBound.load() << " after "
+                  << duration.count() << " s" << std::endl;
+
+        solver.write(instance, std::cout);
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "instance.h"
+
+// Summary of an instance for picking a strategy before scheduling, a single pass over the tasks and dependencies
+struct InstanceFeatures {
+    double noTasks = 0;
+
+    // Dependencies per task and the share of them that are data dependencies
+    double edgeDensity = 0;
+    double dataEdgeRatio = 0;
+
+    // Levels are the number of tasks on the longest dependency chain ending at a task, depth is the highest level and
+    // width the most tasks on one level
+    double depth = 0;
+    double width = 0;
+
+    // Average share of the machines a task can run on
+    double affinitySpread = 0;
+
+    // Total disk capacity over total data size
+    double diskSlack = 0;
+
+    static constexpr int noFeatures = 7;
+    static constexpr std::array<std::string_view, noFeatures> names = {
+            "noTasks", "edgeDensity", "dataEdgeRatio", "depth", "width", "affinitySpread", "diskSlack",
+    };
+
+    InstanceFeatures() = default;
+
+    explicit InstanceFeatures(const Instance &instance) {
+        int n = instance.noTasks();
+        noTasks = n;
+
+        long long noDataEdges = 0;
+        long long noTaskEdges = 0;
+        long long noAffinities = 0;
+        long long totalDataSize = 0;
+
+        std::vector<int> remainingDependencies(n);
+        std::vector<int> order;
+        order.reserve(n);
+
+        for (int i = 0; i < n; i++) {
+            auto dataDependencies = (int) instance.dataDependenciesOf(i).size();
+            auto taskDependencies = (int) instance.taskDependenciesOf(i).size();
+
+            noDataEdges += dataDependencies;
+            noTaskEdges += taskDependencies;
+            noAffinities += (long long) instance.affinitiesOf(i).size();
+            totalDataSize += instance.tasks[i].dataSize;
+
+            remainingDependencies[i] = dataDependencies + taskDependencies;
+            if (remainingDependencies[i] == 0) {
+                order.push_back(i);
+            }
+        }
+
+        std::vector<int> level(n, 1);
+        std::vector<int> levelSizes(2);
+
+        for (std::size_t k = 0; k < order.size(); k++) {
+            int i = order[k];
+
+            if (level[i] >= (int) levelSizes.size()) {
+                levelSizes.resize(level[i] + 1);
+            }
+
+            levelSizes[level[i]]++;
+
+            auto release = [&](int j) {
+                level[j] = std::max(level[j], level[i] + 1);
+                if (--remainingDependencies[j] == 0) {
+                    order.push_back(j);
+                }
+            };
+
+            for (int j : instance.dataDependentsOf(i)) {
+                release(j);
+            }
+
+            for (int j : instance.taskDependentsOf(i)) {
+                release(j);
+            }
+        }
+
+        long long noEdges = noDataEdges + noTaskEdges;
+
+        edgeDensity = n > 0 ? (double) noEdges / n : 0;
+        dataEdgeRatio = noEdges > 0 ? (double) noDataEdges / (double) noEdges : 0;
+
+        depth = (double) levelSizes.size() - 1;
+        width = *std::max_element(levelSizes.begin(), levelSizes.end());
+
+        if (n > 0 && instance.noMachines() > 0) {
+            affinitySpread = (double) noAffinities / n / instance.noMachines();
+        }
+
+        long long totalCapacity = 0;
+        for (int i = 0; i < instance.noDisks(); i++) {
+            totalCapacity += instance.disks[i].capacity;
+        }
+
+        diskSlack = totalDataSize > 0 ? (double) totalCapacity / (double) totalDataSize : 0;
+    }
+
+    [[nodiscard]] std::array<double, noFeatures> values() const {
+        return {noTasks, edgeDensity, dataEdgeRatio, depth, width, affinitySpread, diskSlack};
+    }
+
+    // One "name value" line per feature
+    void write(std::ostream &out) const {
+        auto featureValues = values();
+        for (int i = 0; i < noFeatures; i++) {
+            out << names[i] << " " << featureValues[i] << "\n";
+        }
+    }
+};
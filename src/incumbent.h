@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "bounds.h"
+#include "instance.h"
+
+// Best makespan found so far by the strategies of a portfolio, shared between their threads. A strategy that builds
+// its schedule one task at a time checks every placed task against it and gives up once the tails of the lower bounds
+// show the schedule must end later than the incumbent. A strategy that could still tie is never cancelled, so which
+// strategy wins a tie does not depend on thread timing.
+struct Incumbent {
+    std::atomic<int> makespan = std::numeric_limits<int>::max();
+    LowerBounds bounds;
+
+    explicit Incumbent(const Instance &instance) : bounds(instance) {
+    }
+
+    // Whether a schedule in which the task with the given instance index ends its run and its write at these times
+    // must end later than the incumbent
+    [[nodiscard]] bool isBeaten(int task, int endRunTime, int endWriteTime) const {
+        int incumbentMakespan = makespan.load(std::memory_order_relaxed);
+        int bound = std::max(endWriteTime + bounds.tailAfterWrite[task], endRunTime + bounds.tailAfterRun[task]);
+        return bound > incumbentMakespan;
+    }
+
+    // Returns whether the makespan of a complete schedule became the new incumbent
+    bool offer(int completeMakespan) {
+        int current = makespan.load();
+        while (completeMakespan < current) {
+            if (makespan.compare_exchange_weak(current, completeMakespan)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
@@ -0,0 +1,561 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+constexpr char INSTANCE_MAGIC[8] = {'W', 'F', '2', 'I', 'N', 'S', 'T', '\0'};
+constexpr std::uint32_t INSTANCE_VERSION = 1;
+
+struct InstanceHeader {
+    char magic[8];
+    std::uint32_t version;
+
+    std::uint32_t noTasks;
+    std::uint32_t noMachines;
+    std::uint32_t noDisks;
+
+    std::uint32_t noAffinities;
+    std::uint32_t noDataDependencies;
+    std::uint32_t noTaskDependencies;
+
+    std::uint32_t reserved[7];
+};
+
+static_assert(sizeof(InstanceHeader) == 64);
+
+struct TaskRecord {
+    std::int32_t id;
+    std::int32_t taskSize;
+    std::int32_t dataSize;
+};
+
+struct MachineRecord {
+    std::int32_t id;
+    std::int32_t power;
+};
+
+struct DiskRecord {
+    std::int32_t id;
+    std::int32_t speed;
+    std::int32_t capacity;
+};
+
+// Binary layout, every section is an array of 32-bit integers following the header:
+// tasks, machines, disks, then CSR offsets (noTasks + 1 entries) and indices for affinities (machine indices),
+// data dependencies, data dependents, task dependencies and task dependents (task indices).
+// Edges are grouped per task in input order, so iterating a CSR row matches the order of the text format.
+struct InstanceLayout {
+    std::size_t tasks = 0;
+    std::size_t machines = 0;
+    std::size_t disks = 0;
+
+    std::size_t affinityOffsets = 0;
+    std::size_t affinities = 0;
+
+    std::size_t dataDependencyOffsets = 0;
+    std::size_t dataDependencies = 0;
+    std::size_t dataDependentOffsets = 0;
+    std::size_t dataDependents = 0;
+
+    std::size_t taskDependencyOffsets = 0;
+    std::size_t taskDependencies = 0;
+    std::size_t taskDependentOffsets = 0;
+    std::size_t taskDependents = 0;
+
+    std::size_t size = 0;
+
+    explicit InstanceLayout(const InstanceHeader &header) {
+        std::size_t offset = sizeof(InstanceHeader) / sizeof(std::int32_t);
+        std::size_t noOffsets = header.noTasks + 1;
+
+        auto take = [&](std::size_t count) {
+            std::size_t start = offset;
+            offset += count;
+            return start;
+        };
+
+        tasks = take(header.noTasks * sizeof(TaskRecord) / sizeof(std::int32_t));
+        machines = take(header.noMachines * sizeof(MachineRecord) / sizeof(std::int32_t));
+        disks = take(header.noDisks * sizeof(DiskRecord) / sizeof(std::int32_t));
+
+        affinityOffsets = take(noOffsets);
+        affinities = take(header.noAffinities);
+
+        dataDependencyOffsets = take(noOffsets);
+        dataDependencies = take(header.noDataDependencies);
+        dataDependentOffsets = take(noOffsets);
+        dataDependents = take(header.noDataDependencies);
+
+        taskDependencyOffsets = take(noOffsets);
+        taskDependencies = take(header.noTaskDependencies);
+        taskDependentOffsets = take(noOffsets);
+        taskDependents = take(header.noTaskDependencies);
+
+        size = offset;
+    }
+};
+
+struct Instance {
+    const InstanceHeader *header = nullptr;
+
+    const TaskRecord *tasks = nullptr;
+    const MachineRecord *machines = nullptr;
+    const DiskRecord *disks = nullptr;
+
+    const std::int32_t *affinityOffsets = nullptr;
+    const std::int32_t *affinities = nullptr;
+
+    const std::int32_t *dataDependencyOffsets = nullptr;
+    const std::int32_t *dataDependencies = nullptr;
+    const std::int32_t *dataDependentOffsets = nullptr;
+    const std::int32_t *dataDependents = nullptr;
+
+    const std::int32_t *taskDependencyOffsets = nullptr;
+    const std::int32_t *taskDependencies = nullptr;
+    const std::int32_t *taskDependentOffsets = nullptr;
+    const std::int32_t *taskDependents = nullptr;
+
+    bool binary = false;
+    bool mapped = false;
+
+    Instance() = default;
+
+    Instance(const Instance &) = delete;
+    Instance &operator=(const Instance &) = delete;
+
+    ~Instance() {
+        release();
+    }
+
+    [[nodiscard]] int noTasks() const {
+        return (int) header->noTasks;
+    }
+
+    [[nodiscard]] int noMachines() const {
+        return (int) header->noMachines;
+    }
+
+    [[nodiscard]] int noDisks() const {
+        return (int) header->noDisks;
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> affinitiesOf(int task) const {
+        return row(affinityOffsets, affinities, task);
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> dataDependenciesOf(int task) const {
+        return row(dataDependencyOffsets, dataDependencies, task);
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> dataDependentsOf(int task) const {
+        return row(dataDependentOffsets, dataDependents, task);
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> taskDependenciesOf(int task) const {
+        return row(taskDependencyOffsets, taskDependencies, task);
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> taskDependentsOf(int task) const {
+        return row(taskDependentOffsets, taskDependents, task);
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const {
+        return {reinterpret_cast<const std::byte *>(header), imageSize * sizeof(std::int32_t)};
+    }
+
+    // Loads an instance from a file descriptor holding either the binary or the text format.
+    // Regular files are memory-mapped, binary instances are used in place without any parsing.
+    void load(int fd) {
+        release();
+
+        struct stat info{};
+        if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                mapping = data;
+                mappingSize = info.st_size;
+
+                if (isBinary(static_cast<const char *>(data), mappingSize)) {
+                    attach(static_cast<const std::int32_t *>(data), mappingSize);
+                    binary = true;
+                    mapped = true;
+                } else {
+                    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+                    parseText(static_cast<const char *>(data), mappingSize);
+                    munmap(mapping, mappingSize);
+                    mapping = nullptr;
+                }
+
+                return;
+            }
+        }
+
+        std::string contents;
+        char chunk[1 << 16];
+
+        ssize_t read;
+        while ((read = ::read(fd, chunk, sizeof(chunk))) > 0) {
+            contents.append(chunk, read);
+        }
+
+        load(contents.data(), contents.size());
+    }
+
+    void load(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+
+        try {
+            load(fd);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+
+        close(fd);
+    }
+
+    void load(const char *data, std::size_t size) {
+        release();
+
+        if (isBinary(data, size)) {
+            storage.resize((size + sizeof(std::int32_t) - 1) / sizeof(std::int32_t));
+            std::memcpy(storage.data(), data, size);
+            attach(storage.data(), size);
+            binary = true;
+        } else {
+            parseText(data, size);
+        }
+    }
+
+    void writeText(std::ostream &out) const {
+        out << noTasks() << "\n";
+        for (int i = 0; i < noTasks(); i++) {
+            out << tasks[i].id << " " << tasks[i].taskSize << " " << tasks[i].dataSize;
+
+            auto taskAffinities = affinitiesOf(i);
+            out << " " << taskAffinities.size();
+            for (int machine : taskAffinities) {
+                out << " " << machines[machine].id;
+            }
+
+            out << "\n";
+        }
+
+        out << noMachines() << "\n";
+        for (int i = 0; i < noMachines(); i++) {
+            out << machines[i].id << " " << machines[i].power << "\n";
+        }
+
+        out << noDisks() << "\n";
+        for (int i = 0; i < noDisks(); i++) {
+            out << disks[i].id << " " << disks[i].speed << " " << disks[i].capacity << "\n";
+        }
+
+        writeTextEdges(out, header->noDataDependencies, dataDependentOffsets, dataDependents);
+        writeTextEdges(out, header->noTaskDependencies, taskDependentOffsets, taskDependents);
+    }
+
+    void writeBinary(std::ostream &out) const {
+        auto data = bytes();
+        out.write(reinterpret_cast<const char *>(data.data()), (std::streamsize) data.size());
+    }
+
+private:
+    std::size_t imageSize = 0;
+
+    std::vector<std::int32_t> storage;
+
+    void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+
+    static bool isBinary(const char *data, std::size_t size) {
+        return size >= sizeof(InstanceHeader) && std::memcmp(data, INSTANCE_MAGIC, sizeof(INSTANCE_MAGIC)) == 0;
+    }
+
+    static std::span<const std::int32_t> row(const std::int32_t *offsets, const std::int32_t *values, int task) {
+        return {values + offsets[task], values + offsets[task + 1]};
+    }
+
+    void release() {
+        if (mapping != nullptr) {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            mappingSize = 0;
+        }
+
+        storage.clear();
+        storage.shrink_to_fit();
+
+        header = nullptr;
+        binary = false;
+        mapped = false;
+    }
+
+    // Checks the whole image once, so a truncated or corrupted file throws here instead of being read out of bounds
+    void attach(const std::int32_t *data, std::size_t size) {
+        header = reinterpret_cast<const InstanceHeader *>(data);
+        if (header->version != INSTANCE_VERSION) {
+            throw std::runtime_error("Unsupported binary instance version " + std::to_string(header->version));
+        }
+
+        constexpr std::uint32_t maxCount = std::numeric_limits<std::int32_t>::max() - 1;
+        if (header->noTasks > maxCount || header->noMachines > maxCount || header->noDisks > maxCount
+            || header->noAffinities > maxCount || header->noDataDependencies > maxCount
+            || header->noTaskDependencies > maxCount) {
+            throw std::runtime_error("Binary instance has invalid counts");
+        }
+
+        InstanceLayout layout(*header);
+        if (layout.size * sizeof(std::int32_t) > size) {
+            throw std::runtime_error("Binary instance is truncated");
+        }
+
+        imageSize = layout.size;
+
+        tasks = reinterpret_cast<const TaskRecord *>(data + layout.tasks);
+        machines = reinterpret_cast<const MachineRecord *>(data + layout.machines);
+        disks = reinterpret_cast<const DiskRecord *>(data + layout.disks);
+
+        affinityOffsets = data + layout.affinityOffsets;
+        affinities = data + layout.affinities;
+
+        dataDependencyOffsets = data + layout.dataDependencyOffsets;
+        dataDependencies = data + layout.dataDependencies;
+        dataDependentOffsets = data + layout.dataDependentOffsets;
+        dataDependents = data + layout.dataDependents;
+
+        taskDependencyOffsets = data + layout.taskDependencyOffsets;
+        taskDependencies = data + layout.taskDependencies;
+        taskDependentOffsets = data + layout.taskDependentOffsets;
+        taskDependents = data + layout.taskDependents;
+
+        checkRows(affinityOffsets, affinities, header->noAffinities, noMachines(), "affinity");
+        checkRows(dataDependencyOffsets, dataDependencies, header->noDataDependencies, noTasks(), "data dependency");
+        checkRows(dataDependentOffsets, dataDependents, header->noDataDependencies, noTasks(), "data dependent");
+        checkRows(taskDependencyOffsets, taskDependencies, header->noTaskDependencies, noTasks(), "task dependency");
+        checkRows(taskDependentOffsets, taskDependents, header->noTaskDependencies, noTasks(), "task dependent");
+    }
+
+    // The offsets of a CSR section must run from 0 to count without decreasing and its values must lie in [0, bound)
+    void checkRows(const std::int32_t *offsets, const std::int32_t *values, std::uint32_t count, int bound,
+                   const char *name) const {
+        int n = noTasks();
+        if (offsets[0] != 0 || offsets[n] != (std::int32_t) count) {
+            throw std::runtime_error("Binary instance has inconsistent CSR offsets");
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (offsets[i + 1] < offsets[i]) {
+                throw std::runtime_error("Binary instance has inconsistent CSR offsets");
+            }
+        }
+
+        for (std::uint32_t i = 0; i < count; i++) {
+            if (values[i] < 0 || values[i] >= bound) {
+                throw std::runtime_error("Binary instance has " + std::string(name) + " " + std::to_string(values[i])
+                                         + " out of range");
+            }
+        }
+    }
+
+    void parseText(const char *data, std::size_t size) {
+        const char *position = data;
+        const char *end = data + size;
+
+        auto next = [&]() {
+            while (position < end && (*position < '0' || *position > '9') && *position != '-') {
+                position++;
+            }
+
+            if (position == end) {
+                throw std::runtime_error("Ran out of numbers to read");
+            }
+
+            bool negative = *position == '-';
+            if (negative) {
+                position++;
+            }
+
+            std::int32_t value = 0;
+            while (position < end && *position >= '0' && *position <= '9') {
+                value = value * 10 + (*position - '0');
+                position++;
+            }
+
+            return negative ? -value : value;
+        };
+
+        // Counts are bounded like the ones in a binary header, so a negative count throws instead of being allocated
+        auto nextCount = [&]() {
+            std::int32_t count = next();
+            if (count < 0) {
+                throw std::runtime_error("Text instance has invalid counts");
+            }
+
+            return count;
+        };
+
+        InstanceHeader parsedHeader{};
+        std::memcpy(parsedHeader.magic, INSTANCE_MAGIC, sizeof(INSTANCE_MAGIC));
+        parsedHeader.version = INSTANCE_VERSION;
+
+        parsedHeader.noTasks = nextCount();
+
+        std::vector<TaskRecord> taskRecords(parsedHeader.noTasks);
+        std::vector<std::int32_t> affinityCounts(parsedHeader.noTasks);
+        std::vector<std::int32_t> affinityIds;
+
+        for (auto i = 0u; i < parsedHeader.noTasks; i++) {
+            taskRecords[i].id = next();
+            taskRecords[i].taskSize = next();
+            taskRecords[i].dataSize = next();
+
+            affinityCounts[i] = nextCount();
+            for (int j = 0; j < affinityCounts[i]; j++) {
+                affinityIds.push_back(next());
+            }
+        }
+
+        parsedHeader.noAffinities = affinityIds.size();
+
+        parsedHeader.noMachines = nextCount();
+        std::vector<MachineRecord> machineRecords(parsedHeader.noMachines);
+        for (auto &machine : machineRecords) {
+            machine.id = next();
+            machine.power = next();
+        }
+
+        parsedHeader.noDisks = nextCount();
+        std::vector<DiskRecord> diskRecords(parsedHeader.noDisks);
+        for (auto &disk : diskRecords) {
+            disk.id = next();
+            disk.speed = next();
+            disk.capacity = next();
+        }
+
+        std::unordered_map<std::int32_t, std::int32_t> taskIndices;
+        std::unordered_map<std::int32_t, std::int32_t> machineIndices;
+
+        for (auto i = 0u; i < parsedHeader.noTasks; i++) {
+            taskIndices[taskRecords[i].id] = (std::int32_t) i;
+        }
+
+        for (auto i = 0u; i < parsedHeader.noMachines; i++) {
+            machineIndices[machineRecords[i].id] = (std::int32_t) i;
+        }
+
+        auto taskIndex = [&](std::int32_t id) {
+            auto it = taskIndices.find(id);
+            if (it == taskIndices.end()) {
+                throw std::runtime_error("Edge refers to non-existent task " + std::to_string(id));
+            }
+
+            return it->second;
+        };
+
+        auto readEdges = [&]() {
+            std::uint32_t noEdges = nextCount();
+
+            std::vector<std::pair<std::int32_t, std::int32_t>> edges(noEdges);
+            for (auto &[from, to] : edges) {
+                from = taskIndex(next());
+                to = taskIndex(next());
+            }
+
+            return edges;
+        };
+
+        auto dataEdges = readEdges();
+        auto taskEdges = readEdges();
+
+        parsedHeader.noDataDependencies = dataEdges.size();
+        parsedHeader.noTaskDependencies = taskEdges.size();
+
+        InstanceLayout layout(parsedHeader);
+        storage.assign(layout.size, 0);
+
+        std::memcpy(storage.data(), &parsedHeader, sizeof(parsedHeader));
+        std::memcpy(storage.data() + layout.tasks, taskRecords.data(), taskRecords.size() * sizeof(TaskRecord));
+        std::memcpy(storage.data() + layout.machines,
+                    machineRecords.data(),
+                    machineRecords.size() * sizeof(MachineRecord));
+        std::memcpy(storage.data() + layout.disks, diskRecords.data(), diskRecords.size() * sizeof(DiskRecord));
+
+        std::int32_t *offsets = storage.data() + layout.affinityOffsets;
+        std::int32_t *values = storage.data() + layout.affinities;
+        for (auto i = 0u; i < parsedHeader.noTasks; i++) {
+            offsets[i + 1] = offsets[i] + affinityCounts[i];
+        }
+
+        for (auto i = 0u; i < parsedHeader.noAffinities; i++) {
+            auto it = machineIndices.find(affinityIds[i]);
+            if (it == machineIndices.end()) {
+                throw std::runtime_error("Affinity refers to non-existent machine " + std::to_string(affinityIds[i]));
+            }
+
+            values[i] = it->second;
+        }
+
+        fillEdges(dataEdges, layout.dataDependencyOffsets, layout.dataDependencies, false);
+        fillEdges(dataEdges, layout.dataDependentOffsets, layout.dataDependents, true);
+        fillEdges(taskEdges, layout.taskDependencyOffsets, layout.taskDependencies, false);
+        fillEdges(taskEdges, layout.taskDependentOffsets, layout.taskDependents, true);
+
+        attach(storage.data(), storage.size() * sizeof(std::int32_t));
+    }
+
+    void fillEdges(const std::vector<std::pair<std::int32_t, std::int32_t>> &edges,
+                   std::size_t offsetsStart,
+                   std::size_t valuesStart,
+                   bool byFrom) {
+        std::int32_t *offsets = storage.data() + offsetsStart;
+        std::int32_t *values = storage.data() + valuesStart;
+
+        auto n = reinterpret_cast<const InstanceHeader *>(storage.data())->noTasks;
+
+        for (const auto &[from, to] : edges) {
+            offsets[(byFrom ? from : to) + 1]++;
+        }
+
+        for (auto i = 0u; i < n; i++) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        std::vector<std::int32_t> cursor(offsets, offsets + n);
+        for (const auto &[from, to] : edges) {
+            if (byFrom) {
+                values[cursor[from]++] = to;
+            } else {
+                values[cursor[to]++] = from;
+            }
+        }
+    }
+
+    void writeTextEdges(std::ostream &out,
+                        std::uint32_t noEdges,
+                        const std::int32_t *offsets,
+                        const std::int32_t *values) const {
+        out << noEdges << "\n";
+        for (int i = 0; i < noTasks(); i++) {
+            for (int j = offsets[i]; j < offsets[i + 1]; j++) {
+                out << tasks[i].id << " " << tasks[values[j]].id << "\n";
+            }
+        }
+    }
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "arena.h"
+#include "reduction.h"
+#include "timeline.h"
+
+// Forward-backward improvement of a schedule with fixed machine and disk assignment.
+// Every dependency is an edge i -> j with a lag, start[j] >= start[i] + lag: data dependencies lag by the duration
+// of i and task dependencies by the duration without the write.
+// The backward pass places every task as late as possible within the makespan, in decreasing order of start time and
+// on mirrored machine timelines, then the forward pass places them as early as possible in increasing order of their
+// new start times. Tasks keep their machines but may pass each other through free gaps.
+// Placing tasks in the order of a feasible schedule never moves one beyond its old position: a task placed before it
+// started no later and only moved further away, so its old slot is still free. The makespan can therefore only shrink.
+struct Justification {
+    Justification(std::span<const int> duration,
+                  std::span<const int> writeTime,
+                  std::span<const int> machineOf,
+                  int noMachines,
+                  const CsrGraph &dataDependencies,
+                  const CsrGraph &taskDependencies,
+                  TimelineEngine engine)
+        : duration(duration.begin(), duration.end()),
+          machineOf(machineOf.begin(), machineOf.end()),
+          noMachines(noMachines),
+          engine(engine) {
+        int n = (int) duration.size();
+
+        predecessorOffsets.assign(n + 1, 0);
+        for (int i = 0; i < n; i++) {
+            predecessorOffsets[i + 1] = predecessorOffsets[i]
+                                        + (int) dataDependencies.successorsOf(i).size()
+                                        + (int) taskDependencies.successorsOf(i).size();
+        }
+
+        predecessors.reserve(predecessorOffsets[n]);
+        predecessorLags.reserve(predecessorOffsets[n]);
+
+        for (int i = 0; i < n; i++) {
+            for (int d : dataDependencies.successorsOf(i)) {
+                predecessors.push_back(d);
+                predecessorLags.push_back(duration[d]);
+            }
+
+            for (int d : taskDependencies.successorsOf(i)) {
+                predecessors.push_back(d);
+                predecessorLags.push_back(duration[d] - writeTime[d]);
+            }
+        }
+
+        successorOffsets.assign(n + 1, 0);
+        for (int d : predecessors) {
+            successorOffsets[d + 1]++;
+        }
+
+        for (int i = 0; i < n; i++) {
+            successorOffsets[i + 1] += successorOffsets[i];
+        }
+
+        successors.resize(predecessors.size());
+        successorLags.resize(predecessors.size());
+
+        std::vector<int> cursor(successorOffsets.begin(), successorOffsets.end() - 1);
+        for (int i = 0; i < n; i++) {
+            for (int j = predecessorOffsets[i]; j < predecessorOffsets[i + 1]; j++) {
+                int from = predecessors[j];
+                successors[cursor[from]] = i;
+                successorLags[cursor[from]] = predecessorLags[j];
+                cursor[from]++;
+            }
+        }
+    }
+
+    [[nodiscard]] int makespanOf(const std::vector<int> &startTimes) const {
+        int makespan = 0;
+        for (std::size_t i = 0; i < startTimes.size(); i++) {
+            makespan = std::max(makespan, startTimes[i] + duration[i]);
+        }
+
+        return makespan;
+    }
+
+    // Runs maxIterations backward-forward pass pairs, or stops early if a pair would increase the makespan or the
+    // makespan reached targetMakespan. Pairs that keep the makespan are still taken as they move tasks into different
+    // gaps. Returns the makespan of the justified start times.
+    int run(std::vector<int> &startTimes, int maxIterations, int targetMakespan = 0) {
+        int makespan = makespanOf(startTimes);
+
+        std::vector<int> justified(startTimes.size());
+
+        for (int iteration = 0; iteration < maxIterations && makespan > targetMakespan; iteration++) {
+            backward(startTimes, justified, makespan);
+            forward(justified, justified);
+
+            int justifiedMakespan = makespanOf(justified);
+            if (justifiedMakespan > makespan) {
+                break;
+            }
+
+            startTimes.swap(justified);
+            makespan = justifiedMakespan;
+        }
+
+        return makespan;
+    }
+
+    // Places every task as early as possible in increasing order of its current start time
+    void forward(const std::vector<int> &startTimes, std::vector<int> &justified) {
+        sortBy(startTimes, false);
+        resetTimelines();
+
+        for (int i : order) {
+            int minStartTime = 0;
+            for (int j = predecessorOffsets[i]; j < predecessorOffsets[i + 1]; j++) {
+                minStartTime = std::max(minStartTime, justified[predecessors[j]] + predecessorLags[j]);
+            }
+
+            Timeline &timeline = timelines[machineOf[i]];
+            justified[i] = timeline.earliestFit(minStartTime, duration[i]);
+            timeline.reserve(justified[i], justified[i] + duration[i]);
+        }
+    }
+
+    // Places every task as late as possible within makespan in decreasing order of its current start time.
+    // Time is mirrored so the latest fit is the earliest fit on timelines running backwards from the makespan.
+    void backward(const std::vector<int> &startTimes, std::vector<int> &justified, int makespan) {
+        sortBy(startTimes, true);
+        resetTimelines();
+
+        for (int i : order) {
+            int minMirroredStart = 0;
+            for (int j = successorOffsets[i]; j < successorOffsets[i + 1]; j++) {
+                minMirroredStart = std::max(minMirroredStart,
+                                            makespan - justified[successors[j]] + successorLags[j] - duration[i]);
+            }
+
+            Timeline &timeline = timelines[machineOf[i]];
+            int mirroredStart = timeline.earliestFit(minMirroredStart, duration[i]);
+            timeline.reserve(mirroredStart, mirroredStart + duration[i]);
+
+            justified[i] = makespan - mirroredStart - duration[i];
+        }
+    }
+
+private:
+    std::vector<int> duration;
+    std::vector<int> machineOf;
+    int noMachines = 0;
+
+    std::vector<int> predecessorOffsets;
+    std::vector<int> predecessors;
+    std::vector<int> predecessorLags;
+
+    std::vector<int> successorOffsets;
+    std::vector<int> successors;
+    std::vector<int> successorLags;
+
+    std::vector<int> order;
+
+    TimelineEngine engine;
+    Arena arena;
+    std::vector<Timeline> timelines;
+
+    void sortBy(const std::vector<int> &startTimes, bool descending) {
+        order.resize(startTimes.size());
+        std::iota(order.begin(), order.end(), 0);
+
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            if (startTimes[a] != startTimes[b]) {
+                return descending ? startTimes[a] > startTimes[b] : startTimes[a] < startTimes[b];
+            }
+
+            return descending ? a > b : a < b;
+        });
+    }
+
+    void resetTimelines() {
+        timelines.clear();
+        arena.reset();
+
+        for (int i = 0; i < noMachines; i++) {
+            timelines.emplace_back(arena, engine);
+        }
+    }
+};
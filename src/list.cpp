@@ -0,0 +1,37 @@
+#include <exception>
+#include <ios>
+#include <iostream>
+
+#include "list.h"
+
+// The policies are set per build target, see add_list_solver in CMakeLists.txt
+#ifndef PRIORITY_POLICY
+#define PRIORITY_POLICY DownwardRankPriority
+#endif
+
+#ifndef DISK_POLICY
+#define DISK_POLICY DiskActivityDisk
+#endif
+
+#ifndef PLACEMENT_POLICY
+#define PLACEMENT_POLICY IntervalPlacement
+#endif
+
+#ifndef TIE_BREAK_POLICY
+#define TIE_BREAK_POLICY WeakerMachineTieBreak
+#endif
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    try {
+        ListSolver<PRIORITY_POLICY, DISK_POLICY, PLACEMENT_POLICY, TIE_BREAK_POLICY> solver;
+        solver.run();
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
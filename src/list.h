@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "incumbent.h"
+#include "instance.h"
+#include "policies.h"
+
+// List scheduler that places one ready task at a time at the option that ends first over its affinity machines.
+// How tasks are prioritized, which disks they write to, how machine time is handed out and how ties between options
+// are broken are policies from policies.h, chosen at compile time so the inner loops have no dispatch.
+template<typename PriorityPolicy, typename DiskPolicy, typename PlacementPolicy, typename TieBreakPolicy>
+struct ListSolver {
+    struct Machine {
+        int id = 0;
+        int power = 0;
+
+        PlacementPolicy timeline;
+    };
+
+    struct Disk {
+        int id = 0;
+        int speed = 0;
+        int capacity = 0;
+
+        int usedCapacity = 0;
+    };
+
+    struct Task {
+        int id = 0;
+
+        int taskSize = 0;
+        int dataSize = 0;
+
+        std::vector<Machine *> affinities;
+
+        std::vector<Task *> dataDependencies;
+        std::vector<Task *> dataDependents;
+
+        std::vector<Task *> taskDependencies;
+        std::vector<Task *> taskDependents;
+
+        int startTime = 0;
+        Machine *machine = nullptr;
+        Disk *disk = nullptr;
+
+        // Data and task dependencies (dependents) without duplicates, in instance order
+        std::vector<Task *> dependencies;
+        std::vector<Task *> dependents;
+
+        double priority = -1;
+
+        int writeTime = 0;
+
+        int endRunTime = 0;
+        int endWriteTime = 0;
+
+        // Position in the instance the tasks were loaded from
+        int index = 0;
+
+        [[nodiscard]] bool hasUnscheduledDependencies() const {
+            return std::any_of(dependencies.begin(), dependencies.end(), [](const Task *task) {
+                return task->machine == nullptr;
+            });
+        }
+
+        [[nodiscard]] bool hasUnprioritizedDependents() const {
+            return std::any_of(dependents.begin(), dependents.end(), [](const Task *task) {
+                return task->priority == -1;
+            });
+        }
+    };
+
+    struct ScheduleOption {
+        Task *task = nullptr;
+        Machine *machine = nullptr;
+        int startTime = 0;
+        int endTime = 0;
+    };
+
+    std::unordered_map<int, Task> tasks;
+    std::unordered_map<int, Machine> machines;
+    std::unordered_map<int, Disk> disks;
+
+    std::vector<Disk *> sortedDisks;
+
+    // In a portfolio, scheduling gives up as soon as the schedule must end later than the incumbent and sets cancelled
+    const Incumbent *incumbent = nullptr;
+    bool cancelled = false;
+
+    // Reads a text or binary instance from stdin through the shared loader and writes the schedule to stdout
+    void run() {
+        Instance instance;
+        instance.load(STDIN_FILENO);
+
+        load(instance);
+
+        scheduleTasks();
+        write(std::cout);
+    }
+
+    // Builds the tasks, machines and disks from a loaded instance, in the order of the instance
+    void load(const Instance &instance) {
+        for (int i = 0; i < instance.noTasks(); i++) {
+            Task &task = tasks[instance.tasks[i].id];
+            task.id = instance.tasks[i].id;
+            task.taskSize = instance.tasks[i].taskSize;
+            task.dataSize = instance.tasks[i].dataSize;
+            task.index = i;
+
+            for (int machine : instance.affinitiesOf(i)) {
+                task.affinities.push_back(&machines[instance.machines[machine].id]);
+            }
+        }
+
+        for (int i = 0; i < instance.noMachines(); i++) {
+            Machine &machine = machines[instance.machines[i].id];
+            machine.id = instance.machines[i].id;
+            machine.power = instance.machines[i].power;
+        }
+
+        for (int i = 0; i < instance.noDisks(); i++) {
+            Disk &disk = disks[instance.disks[i].id];
+            disk.id = instance.disks[i].id;
+            disk.speed = instance.disks[i].speed;
+            disk.capacity = instance.disks[i].capacity;
+        }
+
+        for (int i = 0; i < instance.noTasks(); i++) {
+            Task &task = tasks[instance.tasks[i].id];
+
+            for (int d : instance.dataDependenciesOf(i)) {
+                Task &dependency = tasks[instance.tasks[d].id];
+                task.dataDependencies.push_back(&dependency);
+                dependency.dataDependents.push_back(&task);
+            }
+
+            for (int d : instance.taskDependenciesOf(i)) {
+                Task &dependency = tasks[instance.tasks[d].id];
+                task.taskDependencies.push_back(&dependency);
+                dependency.taskDependents.push_back(&task);
+            }
+        }
+    }
+
+    void write(std::ostream &out) const {
+        for (const auto &[id, task] : tasks) {
+            out << task.id
+                << " " << task.startTime
+                << " " << task.machine->id
+                << " " << task.disk->id
+                << "\n";
+        }
+    }
+
+    [[nodiscard]] int makespan() const {
+        int makespan = 0;
+        for (const auto &[id, task] : tasks) {
+            makespan = std::max(makespan, task.endWriteTime);
+        }
+
+        return makespan;
+    }
+
+    void scheduleTasks() {
+        setDependenciesDependents();
+        PriorityPolicy::setPriorities(tasks);
+        scheduleDisks();
+        scheduleMachines();
+    }
+
+    // Tasks are ordered by index rather than address, so the schedule does not depend on where tasks are allocated.
+    // The separate v01-v07 sources this replaced visited them in pointer-hash order, which even changed with the size
+    // of Task, so their schedules break ties differently.
+    void setDependenciesDependents() {
+        auto merge = [](std::vector<Task *> &merged, const std::vector<Task *> &a, const std::vector<Task *> &b) {
+            merged.insert(merged.end(), a.begin(), a.end());
+            merged.insert(merged.end(), b.begin(), b.end());
+
+            std::sort(merged.begin(), merged.end(), [](const Task *x, const Task *y) {
+                return x->index < y->index;
+            });
+
+            merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        };
+
+        for (auto &[_, task] : tasks) {
+            merge(task.dependencies, task.dataDependencies, task.taskDependencies);
+            merge(task.dependents, task.dataDependents, task.taskDependents);
+        }
+    }
+
+    void scheduleDisks() {
+        for (auto &[_, disk] : disks) {
+            sortedDisks.push_back(&disk);
+        }
+
+        std::sort(sortedDisks.begin(), sortedDisks.end(), [](const Disk *a, const Disk *b) {
+            return a->speed > b->speed;
+        });
+
+        DiskPolicy::assignDisks(tasks, sortedDisks);
+    }
+
+    void scheduleMachines() {
+        std::vector<Task *> tasksToSchedule;
+
+        for (auto &[_, task] : tasks) {
+            if (!task.hasUnscheduledDependencies()) {
+                tasksToSchedule.push_back(&task);
+            }
+        }
+
+        PriorityPolicy::order(tasksToSchedule);
+
+        while (!tasksToSchedule.empty()) {
+            Task *task = tasksToSchedule.front();
+            tasksToSchedule.erase(tasksToSchedule.begin());
+
+            DiskPolicy::assignDisk(task, sortedDisks);
+
+            ScheduleOption option = findScheduleOption(task);
+
+            task->startTime = option.startTime;
+            task->machine = option.machine;
+
+            task->endRunTime = option.endTime - task->writeTime;
+            task->endWriteTime = option.endTime;
+
+            option.machine->timeline.reserve(option.startTime, option.endTime);
+
+            if (incumbent != nullptr && incumbent->isBeaten(task->index, task->endRunTime, task->endWriteTime)) {
+                cancelled = true;
+                return;
+            }
+
+            bool addedTasks = false;
+            for (auto *t : task->dependents) {
+                if (!t->hasUnscheduledDependencies()) {
+                    tasksToSchedule.push_back(t);
+                    addedTasks = true;
+                }
+            }
+
+            if (addedTasks) {
+                PriorityPolicy::order(tasksToSchedule);
+            }
+        }
+    }
+
+    ScheduleOption findScheduleOption(Task *task) {
+        int minStartTime = 0;
+        int readTime = 0;
+
+        for (const auto *t : task->dataDependencies) {
+            minStartTime = std::max(minStartTime, t->endWriteTime);
+            readTime += t->writeTime;
+        }
+
+        for (const auto *t : task->taskDependencies) {
+            minStartTime = std::max(minStartTime, t->endRunTime);
+        }
+
+        Machine *bestMachine = nullptr;
+        int bestStartTime = -1;
+        int bestEndTime = -1;
+
+        for (Machine *machine : task->affinities) {
+            int runTime = std::ceil((double) task->taskSize / (double) machine->power);
+            int duration = readTime + runTime + task->writeTime;
+
+            machine->timeline.forEachStartTime(minStartTime, duration, [&](int startTime) {
+                int endTime = startTime + duration;
+
+                if (bestMachine == nullptr || TieBreakPolicy::isBetter(endTime, machine, bestEndTime, bestMachine)) {
+                    bestMachine = machine;
+                    bestStartTime = startTime;
+                    bestEndTime = endTime;
+                }
+            });
+        }
+
+        ScheduleOption option;
+        option.task = task;
+        option.machine = bestMachine;
+        option.startTime = bestStartTime;
+        option.endTime = bestEndTime;
+
+        return option;
+    }
+};
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "instance.h"
+#include "online.h"
+
+#ifdef LOCAL
+#define log if (true) std::cerr
+#else
+#define log if (false) std::cerr
+#endif
+
+// Replays an instance as a stream of submissions to the online scheduler, one task at a time in input order,
+// and reports the latency of the submissions
+int main(int argc, char *argv[]) {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    TimelineEngine engine = TimelineEngine::Intervals;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+
+        if (arg.starts_with("--timeline=")) {
+            engine = parseTimelineEngine(value);
+        }
+    }
+
+    Instance instance;
+
+    try {
+        instance.load(STDIN_FILENO);
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    OnlineScheduler scheduler(engine);
+
+    for (int i = 0; i < instance.noMachines(); i++) {
+        scheduler.addMachine(instance.machines[i].id, instance.machines[i].power);
+    }
+
+    for (int i = 0; i < instance.noDisks(); i++) {
+        scheduler.addDisk(instance.disks[i].id, instance.disks[i].speed, instance.disks[i].capacity);
+    }
+
+    scheduler.reserve(instance.noTasks());
+
+    std::vector<double> latencies;
+    latencies.reserve(instance.noTasks());
+
+    OnlineTask task;
+
+    for (int i = 0; i < instance.noTasks(); i++) {
+        task.id = instance.tasks[i].id;
+        task.taskSize = instance.tasks[i].taskSize;
+        task.dataSize = instance.tasks[i].dataSize;
+
+        task.affinities.clear();
+        for (int machine : instance.affinitiesOf(i)) {
+            task.affinities.push_back(instance.machines[machine].id);
+        }
+
+        task.dataDependencies.clear();
+        for (int d : instance.dataDependenciesOf(i)) {
+            task.dataDependencies.push_back(instance.tasks[d].id);
+        }
+
+        task.taskDependencies.clear();
+        for (int d : instance.taskDependenciesOf(i)) {
+            task.taskDependencies.push_back(instance.tasks[d].id);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        try {
+            scheduler.submit(task);
+        } catch (const std::exception &err) {
+            std::cerr << err.what() << std::endl;
+            return 1;
+        }
+
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    if (scheduler.noWaiting() > 0) {
+        std::cerr << scheduler.noWaiting() << " task(s) still wait for their dependencies" << std::endl;
+        return 1;
+    }
+
+    scheduler.write(std::cout);
+
+    std::sort(latencies.begin(), latencies.end());
+
+    double total = 0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+
+    if (!latencies.empty()) {
+        log << "Submitted " << latencies.size() << " tasks, makespan " << scheduler.makespan()
+            << ", latency mean " << total / (double) latencies.size()
+            << " us, median " << latencies[latencies.size() / 2]
+            << " us, p99 " << latencies[latencies.size() * 99 / 100]
+            << " us, max " << latencies.back() << " us" << std::endl;
+    }
+
+    return 0;
+}
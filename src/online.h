@@ -0,0 +1,452 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "timeline.h"
+
+// A task submitted to the online scheduler. Machines and dependencies are referred to by id, dependencies may be
+// submitted later, the task then waits until all of them are placed. It starts no earlier than its release time.
+struct OnlineTask {
+    int id = 0;
+    int taskSize = 0;
+    int dataSize = 0;
+    int releaseTime = 0;
+
+    std::vector<int> affinities;
+    std::vector<int> dataDependencies;
+    std::vector<int> taskDependencies;
+};
+
+struct OnlinePlacement {
+    int startTime = 0;
+    int machine = -1;
+    int disk = -1;
+    int endRunTime = 0;
+    int endWriteTime = 0;
+};
+
+// Schedules tasks as they arrive into the free intervals of the machine timelines and the remaining disk capacity,
+// never moving a task once it is placed. A task is placed as soon as all its dependencies are, at the option that ends
+// first over its affinity machines like v08's list scheduling, and writes to the fastest disk that still has room.
+// A submission costs a scan of the task's affinity machines for each task it places.
+struct OnlineScheduler {
+    explicit OnlineScheduler(TimelineEngine engine = TimelineEngine::Intervals) : engine(engine) {
+    }
+
+    OnlineScheduler(const OnlineScheduler &) = delete;
+    OnlineScheduler &operator=(const OnlineScheduler &) = delete;
+
+    void addMachine(int id, int power) {
+        if (power <= 0 || !machineOfId.emplace(id, (int) machines.size()).second) {
+            throw std::invalid_argument("Invalid or duplicate machine " + std::to_string(id));
+        }
+
+        machines.push_back({id, power});
+        timelines.emplace_back(arena, engine);
+    }
+
+    void addDisk(int id, int speed, int capacity) {
+        if (speed <= 0 || !diskOfId.emplace(id, (int) disks.size()).second) {
+            throw std::invalid_argument("Invalid or duplicate disk " + std::to_string(id));
+        }
+
+        disks.push_back({id, speed, capacity, 0});
+    }
+
+    // Avoids reallocations while the first noTasks tasks are submitted
+    void reserve(int noTasks) {
+        tasks.reserve(noTasks);
+        taskOfId.reserve(noTasks);
+    }
+
+    // Accepts a task and places it and every waiting task it unblocks. Returns the ids of the tasks placed by this
+    // submission in the order they were placed, valid until the next call. Throws without accepting the task if it is
+    // a duplicate, has no or unknown affinities, depends on itself, closes a cycle of dependencies or would place a
+    // task that has no disk with room for its data. A rejected task leaves the scheduler as it was.
+    const std::vector<int> &submit(const OnlineTask &submitted) {
+        validate(submitted);
+        checkDiskRoom(submitted);
+
+        int index = (int) tasks.size();
+        Task &task = tasks.emplace_back();
+        task.id = submitted.id;
+        task.taskSize = submitted.taskSize;
+        task.dataSize = submitted.dataSize;
+        task.releaseTime = submitted.releaseTime;
+
+        for (int machineId : submitted.affinities) {
+            task.affinities.push_back(machineOfId.at(machineId));
+        }
+
+        taskOfId[submitted.id] = index;
+
+        for (int dependencyId : submitted.dataDependencies) {
+            addDependency(dependencyId, index, true);
+        }
+
+        for (int dependencyId : submitted.taskDependencies) {
+            addDependency(dependencyId, index, false);
+        }
+
+        // Tasks submitted earlier that were waiting for this one
+        auto waiting = waitingFor.find(submitted.id);
+        if (waiting != waitingFor.end()) {
+            for (auto [dependent, data] : waiting->second) {
+                link(index, dependent, data);
+            }
+
+            waitingFor.erase(waiting);
+        }
+
+        placed.clear();
+        if (tasks[index].remainingDependencies == 0) {
+            placeFrom(index);
+        }
+
+        return placed;
+    }
+
+    [[nodiscard]] bool isPlaced(int id) const {
+        auto task = taskOfId.find(id);
+        return task != taskOfId.end() && tasks[task->second].placement.machine >= 0;
+    }
+
+    // Machine and disk are ids, the placement of a task that is not placed yet has machine -1
+    [[nodiscard]] OnlinePlacement placementOf(int id) const {
+        auto task = taskOfId.find(id);
+        if (task == taskOfId.end()) {
+            throw std::invalid_argument("Unknown task " + std::to_string(id));
+        }
+
+        OnlinePlacement placement = tasks[task->second].placement;
+        if (placement.machine >= 0) {
+            placement.machine = machines[placement.machine].id;
+            placement.disk = disks[placement.disk].id;
+        }
+
+        return placement;
+    }
+
+    [[nodiscard]] int makespan() const {
+        return currentMakespan;
+    }
+
+    [[nodiscard]] int noWaiting() const {
+        return noSubmitted() - noPlaced;
+    }
+
+    [[nodiscard]] int noSubmitted() const {
+        return (int) tasks.size();
+    }
+
+    // Placed tasks in the solver output format, in the order they were submitted
+    void write(std::ostream &out) const {
+        for (const auto &task : tasks) {
+            if (task.placement.machine >= 0) {
+                out << task.id
+                    << " " << task.placement.startTime
+                    << " " << machines[task.placement.machine].id
+                    << " " << disks[task.placement.disk].id
+                    << "\n";
+            }
+        }
+    }
+
+private:
+    struct Machine {
+        int id = 0;
+        int power = 0;
+    };
+
+    struct Disk {
+        int id = 0;
+        int speed = 0;
+        int capacity = 0;
+        int usedCapacity = 0;
+    };
+
+    struct Task {
+        int id = 0;
+        int taskSize = 0;
+        int dataSize = 0;
+        int releaseTime = 0;
+
+        std::vector<int> affinities;
+        std::vector<int> dataDependencies;
+        std::vector<int> taskDependencies;
+        std::vector<int> dependents;
+
+        int remainingDependencies = 0;
+
+        OnlinePlacement placement;
+        int writeTime = 0;
+    };
+
+    TimelineEngine engine;
+    Arena arena;
+
+    std::vector<Machine> machines;
+    std::vector<Timeline> timelines;
+    std::vector<Disk> disks;
+    std::vector<Task> tasks;
+
+    std::unordered_map<int, int> machineOfId;
+    std::unordered_map<int, int> diskOfId;
+    std::unordered_map<int, int> taskOfId;
+
+    // Dependents by the id of a dependency that was not submitted yet, with whether it is a data dependency
+    std::unordered_map<int, std::vector<std::pair<int, bool>>> waitingFor;
+
+    std::vector<int> placed;
+    std::vector<int> ready;
+
+    int currentMakespan = 0;
+    int noPlaced = 0;
+
+    void validate(const OnlineTask &submitted) const {
+        std::string name = "Task " + std::to_string(submitted.id);
+
+        if (taskOfId.contains(submitted.id)) {
+            throw std::invalid_argument("Duplicate task " + std::to_string(submitted.id));
+        }
+
+        if (submitted.affinities.empty()) {
+            throw std::invalid_argument(name + " has no affinities");
+        }
+
+        for (int machineId : submitted.affinities) {
+            if (!machineOfId.contains(machineId)) {
+                throw std::invalid_argument("Unknown machine " + std::to_string(machineId));
+            }
+        }
+
+        for (const auto *dependencies : {&submitted.dataDependencies, &submitted.taskDependencies}) {
+            if (std::find(dependencies->begin(), dependencies->end(), submitted.id) != dependencies->end()) {
+                throw std::invalid_argument(name + " depends on itself");
+            }
+        }
+
+        if (closesCycle(submitted)) {
+            throw std::invalid_argument(name + " closes a cycle of dependencies");
+        }
+    }
+
+    // The accepted tasks have no cycle, so a new one only exists if a dependency of the task waits for it, directly or
+    // through other waiting tasks. Only tasks that were submitted before the task they wait for are searched.
+    [[nodiscard]] bool closesCycle(const OnlineTask &submitted) const {
+        auto waiting = waitingFor.find(submitted.id);
+        if (waiting == waitingFor.end()) {
+            return false;
+        }
+
+        std::unordered_set<int> dependencies;
+        for (const auto *ids : {&submitted.dataDependencies, &submitted.taskDependencies}) {
+            for (int dependencyId : *ids) {
+                auto dependency = taskOfId.find(dependencyId);
+                if (dependency != taskOfId.end()) {
+                    dependencies.insert(dependency->second);
+                }
+            }
+        }
+
+        if (dependencies.empty()) {
+            return false;
+        }
+
+        std::vector<int> stack;
+        std::unordered_set<int> visited;
+
+        for (auto [dependent, _] : waiting->second) {
+            if (visited.insert(dependent).second) {
+                stack.push_back(dependent);
+            }
+        }
+
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+
+            if (dependencies.contains(i)) {
+                return true;
+            }
+
+            for (int j : tasks[i].dependents) {
+                if (visited.insert(j).second) {
+                    stack.push_back(j);
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // Goes through the tasks the submission would place in the order placeFrom places them and throws if one of them
+    // finds no disk with room. Disks are picked without regard to the machines, so the schedule is not needed.
+    void checkDiskRoom(const OnlineTask &submitted) const {
+        for (const auto *ids : {&submitted.dataDependencies, &submitted.taskDependencies}) {
+            for (int dependencyId : *ids) {
+                if (!isPlaced(dependencyId)) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<Disk> simulatedDisks = disks;
+        std::unordered_map<int, int> remainingDependencies;
+
+        auto waiting = waitingFor.find(submitted.id);
+        std::vector<int> submittedDependents;
+        if (waiting != waitingFor.end()) {
+            for (auto [dependent, _] : waiting->second) {
+                submittedDependents.push_back(dependent);
+            }
+        }
+
+        // The submitted task is -1, it is not in tasks yet
+        std::vector<int> simulatedReady{-1};
+
+        while (!simulatedReady.empty()) {
+            int i = simulatedReady.back();
+            simulatedReady.pop_back();
+
+            int id = i == -1 ? submitted.id : tasks[i].id;
+            int dataSize = i == -1 ? submitted.dataSize : tasks[i].dataSize;
+
+            int disk = fastestDiskWithRoom(simulatedDisks, dataSize);
+            if (disk == -1) {
+                throw std::runtime_error("No disk has room for the data of task " + std::to_string(id));
+            }
+
+            simulatedDisks[disk].usedCapacity += dataSize;
+
+            for (int j : i == -1 ? submittedDependents : tasks[i].dependents) {
+                auto remaining = remainingDependencies.try_emplace(j, tasks[j].remainingDependencies).first;
+                if (--remaining->second == 0) {
+                    simulatedReady.push_back(j);
+                }
+            }
+        }
+    }
+
+    // Index of the fastest disk that still has room for the data, -1 if there is none
+    static int fastestDiskWithRoom(const std::vector<Disk> &disks, int dataSize) {
+        int disk = -1;
+        for (int d = 0; d < (int) disks.size(); d++) {
+            if (disks[d].usedCapacity + dataSize <= disks[d].capacity
+                && (disk == -1 || disks[d].speed > disks[disk].speed)) {
+                disk = d;
+            }
+        }
+
+        return disk;
+    }
+
+    void addDependency(int dependencyId, int dependent, bool data) {
+        tasks[dependent].remainingDependencies++;
+
+        auto dependency = taskOfId.find(dependencyId);
+        if (dependency == taskOfId.end()) {
+            waitingFor[dependencyId].emplace_back(dependent, data);
+        } else {
+            link(dependency->second, dependent, data);
+        }
+    }
+
+    // The dependency counts towards the dependent's remaining dependencies until it is placed
+    void link(int dependency, int dependent, bool data) {
+        (data ? tasks[dependent].dataDependencies : tasks[dependent].taskDependencies).push_back(dependency);
+
+        if (tasks[dependency].placement.machine >= 0) {
+            tasks[dependent].remainingDependencies--;
+        } else {
+            tasks[dependency].dependents.push_back(dependent);
+        }
+    }
+
+    void placeFrom(int index) {
+        ready.assign(1, index);
+
+        while (!ready.empty()) {
+            int i = ready.back();
+            ready.pop_back();
+
+            place(i);
+
+            for (int j : tasks[i].dependents) {
+                if (--tasks[j].remainingDependencies == 0) {
+                    ready.push_back(j);
+                }
+            }
+
+            tasks[i].dependents.clear();
+            tasks[i].dependents.shrink_to_fit();
+        }
+    }
+
+    void place(int i) {
+        Task &task = tasks[i];
+
+        // checkDiskRoom made sure there is one
+        int disk = fastestDiskWithRoom(disks, task.dataSize);
+
+        int minStartTime = task.releaseTime;
+        int readTime = 0;
+
+        for (int d : task.dataDependencies) {
+            minStartTime = std::max(minStartTime, tasks[d].placement.endWriteTime);
+            readTime += tasks[d].writeTime;
+        }
+
+        for (int d : task.taskDependencies) {
+            minStartTime = std::max(minStartTime, tasks[d].placement.endRunTime);
+        }
+
+        task.writeTime = (int) std::ceil((double) task.dataSize / (double) disks[disk].speed);
+
+        int bestMachine = -1;
+        int bestStartTime = 0;
+        int bestEndTime = 0;
+
+        for (int machine : task.affinities) {
+            int runTime = (int) std::ceil((double) task.taskSize / (double) machines[machine].power);
+            int duration = readTime + runTime + task.writeTime;
+
+            int startTime = timelines[machine].earliestFit(minStartTime, duration);
+            int endTime = startTime + duration;
+
+            if (bestMachine == -1
+                || endTime < bestEndTime
+                || (endTime == bestEndTime && machines[machine].power < machines[bestMachine].power)
+                || (endTime == bestEndTime && machines[machine].power == machines[bestMachine].power
+                    && machine < bestMachine)) {
+                bestMachine = machine;
+                bestStartTime = startTime;
+                bestEndTime = endTime;
+            }
+        }
+
+        timelines[bestMachine].reserve(bestStartTime, bestEndTime);
+        disks[disk].usedCapacity += task.dataSize;
+
+        task.placement.startTime = bestStartTime;
+        task.placement.machine = bestMachine;
+        task.placement.disk = disk;
+        task.placement.endWriteTime = bestEndTime;
+        task.placement.endRunTime = bestEndTime - task.writeTime;
+
+        currentMakespan = std::max(currentMakespan, bestEndTime);
+        noPlaced++;
+
+        placed.push_back(task.id);
+    }
+};
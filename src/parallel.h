@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Persistent pool of worker threads, the calling thread takes part in every job so a pool of size 1 has no workers.
+// Jobs hand out indices in small chunks from a shared counter, which balances uneven work per index.
+struct ThreadPool {
+    explicit ThreadPool(int noThreads = defaultSize()) {
+        noThreads = std::max(noThreads, 1);
+
+        for (int i = 1; i < noThreads; i++) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+
+        wakeUp.notify_all();
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    static int defaultSize() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    [[nodiscard]] int size() const {
+        return (int) workers.size() + 1;
+    }
+
+    // Calls body(i) for every i in [begin, end) and returns once all calls have finished. If a call throws, no further
+    // chunks are started and the first exception is rethrown on the calling thread once the running ones have finished.
+    void parallelFor(int begin, int end, const std::function<void(int)> &body, int chunkSize = 64) {
+        if (end - begin <= chunkSize || workers.empty()) {
+            for (int i = begin; i < end; i++) {
+                body(i);
+            }
+
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+
+            job = &body;
+            jobEnd = end;
+            jobChunkSize = chunkSize;
+            next.store(begin);
+            busyWorkers = (int) workers.size();
+            generation++;
+        }
+
+        wakeUp.notify_all();
+
+        runChunks(body, end, chunkSize);
+
+        std::unique_lock lock(mutex);
+        done.wait(lock, [&]() { return busyWorkers == 0; });
+
+        job = nullptr;
+
+        if (error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable done;
+
+    const std::function<void(int)> *job = nullptr;
+    int jobEnd = 0;
+    int jobChunkSize = 1;
+    std::atomic<int> next = 0;
+
+    int busyWorkers = 0;
+    long long generation = 0;
+    std::exception_ptr error;
+    bool stopping = false;
+
+    void runChunks(const std::function<void(int)> &body, int end, int chunkSize) {
+        while (true) {
+            int start = next.fetch_add(chunkSize);
+            if (start >= end) {
+                break;
+            }
+
+            int stop = std::min(end, start + chunkSize);
+
+            try {
+                for (int i = start; i < stop; i++) {
+                    body(i);
+                }
+            } catch (...) {
+                next.store(end);
+
+                std::lock_guard lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void work() {
+        long long seenGeneration = 0;
+
+        while (true) {
+            const std::function<void(int)> *body;
+            int end;
+            int chunkSize;
+
+            {
+                std::unique_lock lock(mutex);
+                wakeUp.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+
+                if (stopping) {
+                    return;
+                }
+
+                seenGeneration = generation;
+
+                body = job;
+                end = jobEnd;
+                chunkSize = jobChunkSize;
+            }
+
+            runChunks(*body, end, chunkSize);
+
+            {
+                std::lock_guard lock(mutex);
+                busyWorkers--;
+            }
+
+            done.notify_one();
+        }
+    }
+};
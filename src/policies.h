@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Policies for the list scheduler in list.h, each family is a set of interchangeable types the solver is instantiated
+// with at compile time. Tasks, machines and disks are the solver's own types, so the policies are written against the
+// fields they use.
+
+// Priority policies set the priority of every task before scheduling and order the tasks that are ready to schedule
+
+// Tasks are scheduled in the order they become ready
+struct ReadyOrderPriority {
+    template<typename Tasks>
+    static void setPriorities(Tasks &) {
+    }
+
+    template<typename Task>
+    static void order(std::vector<Task *> &) {
+    }
+};
+
+// The priority of a task is its size plus the largest data size and priority of its dependents, the longest chain
+// of work that still waits for it. Tasks with the highest priority are scheduled first, the earliest in the instance
+// on ties.
+struct DownwardRankPriority {
+    template<typename Tasks>
+    static void setPriorities(Tasks &tasks) {
+        using Task = typename Tasks::mapped_type;
+        std::queue<Task *> priorityQueue;
+
+        for (auto &[_, task] : tasks) {
+            if (!task.hasUnprioritizedDependents()) {
+                priorityQueue.push(&task);
+            }
+        }
+
+        while (!priorityQueue.empty()) {
+            Task *task = priorityQueue.front();
+
+            double maxDependentPriority = 0;
+            for (auto *t : task->dependents) {
+                maxDependentPriority = std::max(maxDependentPriority, (double) t->dataSize + t->priority);
+            }
+
+            task->priority = (double) task->taskSize + maxDependentPriority;
+
+            for (auto *t : task->dependencies) {
+                if (!t->hasUnprioritizedDependents()) {
+                    priorityQueue.push(t);
+                }
+            }
+
+            priorityQueue.pop();
+        }
+    }
+
+    template<typename Task>
+    static void order(std::vector<Task *> &tasksToSchedule) {
+        std::sort(tasksToSchedule.begin(), tasksToSchedule.end(), [](const Task *a, const Task *b) {
+            if (a->priority != b->priority) {
+                return a->priority > b->priority;
+            }
+
+            return a->index < b->index;
+        });
+    }
+};
+
+// Disk policies pick the disk a task writes its data to, either all up front or when the task is scheduled.
+// Disks are passed fastest first.
+
+// A task writes to the fastest disk that still has room when it is scheduled
+struct FastestFreeDisk {
+    template<typename Tasks, typename Disk>
+    static void assignDisks(Tasks &, const std::vector<Disk *> &) {
+    }
+
+    template<typename Task, typename Disk>
+    static void assignDisk(Task *task, const std::vector<Disk *> &sortedDisks) {
+        setDisk(task, sortedDisks);
+    }
+
+    template<typename Task, typename Disk>
+    static void setDisk(Task *task, const std::vector<Disk *> &sortedDisks) {
+        task->disk = *std::find_if(sortedDisks.begin(), sortedDisks.end(), [&](const Disk *d) {
+            return d->usedCapacity + task->dataSize <= d->capacity;
+        });
+
+        task->disk->usedCapacity += task->dataSize;
+        task->writeTime = std::ceil((double) task->dataSize / (double) task->disk->speed);
+    }
+};
+
+// Before scheduling, the tasks whose data is read and written the most get the fastest disks, ties go to the tasks
+// with the highest priority and then to the earliest in the instance
+struct DiskActivityDisk {
+    template<typename Tasks, typename Disk>
+    static void assignDisks(Tasks &tasks, const std::vector<Disk *> &sortedDisks) {
+        using Task = typename Tasks::mapped_type;
+
+        std::vector<Task *> sortedTasks;
+        for (auto &[_, task] : tasks) {
+            sortedTasks.push_back(&task);
+        }
+
+        std::sort(sortedTasks.begin(), sortedTasks.end(), [](const Task *a, const Task *b) {
+            auto diskActivityA = a->dataSize * (a->dataDependents.size() + 1);
+            auto diskActivityB = b->dataSize * (b->dataDependents.size() + 1);
+
+            if (diskActivityA != diskActivityB) {
+                return diskActivityA > diskActivityB;
+            }
+
+            if (a->priority != b->priority) {
+                return a->priority > b->priority;
+            }
+
+            return a->index < b->index;
+        });
+
+        for (auto *task : sortedTasks) {
+            FastestFreeDisk::setDisk(task, sortedDisks);
+        }
+    }
+
+    template<typename Task, typename Disk>
+    static void assignDisk(Task *, const std::vector<Disk *> &) {
+    }
+};
+
+// Placement policies keep the busy time of a machine, every machine holds one
+
+// A machine runs its tasks back to back in the order they are scheduled
+struct AppendPlacement {
+    int nextStartTime = 0;
+
+    // Calls consider(startTime) for every start time at which a task of this duration fits, in increasing order
+    template<typename F>
+    void forEachStartTime(int minStartTime, int, F &&consider) const {
+        consider(std::max(minStartTime, nextStartTime));
+    }
+
+    void reserve(int, int endTime) {
+        nextStartTime = endTime;
+    }
+};
+
+// A task can go into any idle interval it fits in, including the gaps left before earlier tasks
+struct IntervalPlacement {
+    std::vector<std::pair<int, int>> availableIntervals{{0, std::numeric_limits<int>::max()}};
+
+    template<typename F>
+    void forEachStartTime(int minStartTime, int duration, F &&consider) const {
+        for (const auto &[start, end] : availableIntervals) {
+            int startTime = std::max(minStartTime, start);
+            if (startTime > end) {
+                continue;
+            }
+
+            if (startTime + duration > end) {
+                continue;
+            }
+
+            consider(startTime);
+        }
+    }
+
+    void reserve(int startTime, int endTime) {
+        for (std::size_t i = 0; i < availableIntervals.size(); i++) {
+            int start = availableIntervals[i].first;
+            int end = availableIntervals[i].second;
+
+            if (startTime >= start && endTime <= end) {
+                availableIntervals.erase(availableIntervals.begin() + i);
+
+                if (startTime != start) {
+                    availableIntervals.emplace_back(start, startTime);
+                }
+
+                if (endTime != end) {
+                    availableIntervals.emplace_back(endTime, end);
+                }
+
+                break;
+            }
+        }
+
+        std::sort(availableIntervals.begin(), availableIntervals.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
+    }
+};
+
+// Tie-break policies decide whether an option ending at endTime on machine beats the best one so far
+
+// Only an earlier end counts, the first option found wins ties
+struct EarliestEndTieBreak {
+    template<typename Machine>
+    static bool isBetter(int endTime, const Machine *, int bestEndTime, const Machine *) {
+        return endTime < bestEndTime;
+    }
+};
+
+// Ties go to the machine with the lower power, keeping the faster machines free for later tasks
+struct WeakerMachineTieBreak {
+    template<typename Machine>
+    static bool isBetter(int endTime, const Machine *machine, int bestEndTime, const Machine *bestMachine) {
+        return endTime < bestEndTime || (endTime == bestEndTime && machine->power < bestMachine->power);
+    }
+};
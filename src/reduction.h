@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Graph in CSR form, the successors of node i are targets[offsets[i]] to targets[offsets[i + 1] - 1].
+struct CsrGraph {
+    int noNodes = 0;
+    std::span<const std::int32_t> offsets;
+    std::span<const std::int32_t> targets;
+
+    [[nodiscard]] std::span<const std::int32_t> successorsOf(int node) const {
+        return targets.subspan(offsets[node], offsets[node + 1] - offsets[node]);
+    }
+};
+
+// Topological order of the union of both graphs, empty if they contain a cycle.
+inline std::vector<int> topologicalOrder(const CsrGraph &a, const CsrGraph &b) {
+    int n = a.noNodes;
+
+    std::vector<int> inDegree(n);
+    for (const auto *graph : {&a, &b}) {
+        for (int target : graph->targets) {
+            inDegree[target]++;
+        }
+    }
+
+    std::vector<int> order;
+    order.reserve(n);
+
+    for (int i = 0; i < n; i++) {
+        if (inDegree[i] == 0) {
+            order.push_back(i);
+        }
+    }
+
+    for (std::size_t i = 0; i < order.size(); i++) {
+        for (const auto *graph : {&a, &b}) {
+            for (int target : graph->successorsOf(order[i])) {
+                if (--inDegree[target] == 0) {
+                    order.push_back(target);
+                }
+            }
+        }
+    }
+
+    if (order.size() != (std::size_t) n) {
+        order.clear();
+    }
+
+    return order;
+}
+
+// Marks the edges of weak that are implied by the other edges of both graphs, in CSR order of weak.
+// An edge u -> v of weak is implied if strong also has u -> v, if it duplicates an earlier u -> v of weak,
+// or if v is reachable from u through a path of two or more edges of either graph.
+// Every dependency makes a task start after its dependency has finished running, which is never before it started,
+// so a path through other tasks already enforces whatever the implied edge would.
+//
+// Reachability is computed with bitsets in reverse topological order, in blocks of target columns
+// so memory stays at noNodes * blockSize bits regardless of the graph size.
+inline std::vector<std::uint8_t> findRedundantEdges(const CsrGraph &strong, const CsrGraph &weak) {
+    int n = strong.noNodes;
+    std::vector<std::uint8_t> redundant(weak.targets.size());
+
+    std::vector<int> order = topologicalOrder(strong, weak);
+    if (order.empty() && n > 0) {
+        return redundant;
+    }
+
+    std::vector<int> strongStamp(n, -1);
+    std::vector<int> weakStamp(n, -1);
+
+    for (int u = 0; u < n; u++) {
+        for (int v : strong.successorsOf(u)) {
+            strongStamp[v] = u;
+        }
+
+        for (int j = weak.offsets[u]; j < weak.offsets[u + 1]; j++) {
+            int v = weak.targets[j];
+
+            if (strongStamp[v] == u || weakStamp[v] == u) {
+                redundant[j] = 1;
+            }
+
+            weakStamp[v] = u;
+        }
+    }
+
+    constexpr int blockWords = 128;
+    constexpr int blockSize = blockWords * 64;
+
+    std::vector<std::uint64_t> reach((std::size_t) n * blockWords);
+    std::vector<std::uint64_t> indirect(blockWords);
+
+    for (int blockStart = 0; blockStart < n; blockStart += blockSize) {
+        int blockEnd = std::min(n, blockStart + blockSize);
+        int noWords = (blockEnd - blockStart + 63) / 64;
+
+        for (auto it = order.rbegin(); it != order.rend(); it++) {
+            int u = *it;
+
+            std::fill(indirect.begin(), indirect.begin() + noWords, 0);
+
+            for (const auto *graph : {&strong, &weak}) {
+                for (int v : graph->successorsOf(u)) {
+                    const std::uint64_t *descendants = &reach[(std::size_t) v * blockWords];
+                    for (int w = 0; w < noWords; w++) {
+                        indirect[w] |= descendants[w];
+                    }
+                }
+            }
+
+            for (int j = weak.offsets[u]; j < weak.offsets[u + 1]; j++) {
+                int v = weak.targets[j];
+                if (v >= blockStart && v < blockEnd && (indirect[(v - blockStart) / 64] >> ((v - blockStart) % 64) & 1)) {
+                    redundant[j] = 1;
+                }
+            }
+
+            std::uint64_t *descendants = &reach[(std::size_t) u * blockWords];
+            std::copy(indirect.begin(), indirect.begin() + noWords, descendants);
+
+            for (const auto *graph : {&strong, &weak}) {
+                for (int v : graph->successorsOf(u)) {
+                    if (v >= blockStart && v < blockEnd) {
+                        descendants[(v - blockStart) / 64] |= 1ull << ((v - blockStart) % 64);
+                    }
+                }
+            }
+        }
+    }
+
+    return redundant;
+}
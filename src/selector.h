@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+#include "features.h"
+
+// Generated by results/train.py from the scores of the v08 portfolio strategies on 50 inputs
+inline std::string selectStrategy(const InstanceFeatures &features) {
+    if (features.edgeDensity <= 1.044) {
+        return "v04";
+    }
+
+    if (features.depth <= 8.5) {
+        return "v08-urgent-100";
+    }
+
+    return "v08-urgent-10";
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Length-prefixed requests and replies for a process that schedules a stream of instances.
+// A request is a line with the size in bytes of the instance that follows, in the text or the binary input format.
+// A reply is a line "OK <size> <microseconds>" or "ERR <size> <microseconds>" followed by size bytes of schedule or
+// error message, microseconds is the time the request took from being read to its reply.
+struct RequestStream {
+    RequestStream(int in, int out) : in(in), out(out) {
+    }
+
+    // Reads the next request, returns false at the end of the stream. Throws on a malformed or truncated request,
+    // after which the stream is out of step and should be closed.
+    bool read(std::string &request) {
+        std::string_view line;
+        do {
+            if (!readLine(line)) {
+                return false;
+            }
+        } while (line.empty());
+
+        std::size_t size = 0;
+        auto [end, error] = std::from_chars(line.data(), line.data() + line.size(), size);
+        if (error != std::errc() || end != line.data() + line.size()) {
+            throw std::runtime_error("Malformed request header \"" + std::string(line) + "\"");
+        }
+
+        request.resize(size);
+
+        std::size_t buffered = std::min(size, buffer.size() - position);
+        request.replace(0, buffered, buffer, position, buffered);
+        position += buffered;
+
+        for (std::size_t done = buffered; done < size;) {
+            ssize_t count = ::read(in, request.data() + done, size - done);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count <= 0) {
+                throw std::runtime_error("Request is truncated");
+            }
+
+            done += count;
+        }
+
+        return true;
+    }
+
+    void reply(bool ok, std::string_view body, long long microseconds) {
+        std::string header = (ok ? "OK " : "ERR ") + std::to_string(body.size()) + " " + std::to_string(microseconds) + "\n";
+
+        write(header);
+        write(body);
+    }
+
+private:
+    static constexpr std::size_t readSize = 1 << 16;
+
+    int in;
+    int out;
+
+    std::string buffer;
+    std::size_t position = 0;
+
+    // The line is valid until the next read
+    bool readLine(std::string_view &line) {
+        std::size_t searched = position;
+
+        while (true) {
+            std::size_t newline = buffer.find('\n', searched);
+            if (newline != std::string::npos) {
+                line = std::string_view(buffer).substr(position, newline - position);
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+
+                position = newline + 1;
+                return true;
+            }
+
+            buffer.erase(0, position);
+            searched = buffer.size();
+            position = 0;
+
+            buffer.resize(searched + readSize);
+            ssize_t count;
+            do {
+                count = ::read(in, buffer.data() + searched, readSize);
+            } while (count < 0 && errno == EINTR);
+
+            buffer.resize(searched + std::max<ssize_t>(count, 0));
+
+            if (count < 0) {
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+
+            if (count == 0) {
+                if (buffer.find_first_not_of(" \t\r\n") != std::string::npos) {
+                    throw std::runtime_error("Request header is truncated");
+                }
+
+                return false;
+            }
+        }
+    }
+
+    void write(std::string_view data) {
+        while (!data.empty()) {
+            ssize_t count = ::write(out, data.data(), data.size());
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count < 0) {
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+
+            data.remove_prefix(count);
+        }
+    }
+};
+
+// Listens on a Unix socket at path, replacing a stale socket file, and calls serve(fd) for one connection at a time
+// until accepting fails. The connection is closed when serve returns or throws.
+template<typename F>
+void serveUnixSocket(const std::string &path, F &&serve) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is too long: " + path);
+    }
+
+    path.copy(address.sun_path, path.size());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::system_error(errno, std::generic_category(), "socket");
+    }
+
+    unlink(path.c_str());
+
+    if (bind(listener, (sockaddr *) &address, sizeof(address)) < 0 || listen(listener, 16) < 0) {
+        int error = errno;
+        close(listener);
+        throw std::system_error(error, std::generic_category(), "Cannot listen on " + path);
+    }
+
+    while (true) {
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (connection < 0) {
+            int error = errno;
+            close(listener);
+            throw std::system_error(error, std::generic_category(), "accept");
+        }
+
+        try {
+            serve(connection);
+        } catch (...) {
+            close(connection);
+            close(listener);
+            throw;
+        }
+
+        close(connection);
+    }
+}
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "arena.h"
+
+enum class TimelineEngine {
+    Intervals,
+    Bitmap
+};
+
+inline TimelineEngine parseTimelineEngine(const std::string &name) {
+    if (name == "intervals") {
+        return TimelineEngine::Intervals;
+    }
+
+    if (name == "bitmap") {
+        return TimelineEngine::Bitmap;
+    }
+
+    throw std::invalid_argument("Unknown timeline engine " + name);
+}
+
+// Free time of a machine as a list of [start, end] intervals sorted by start.
+struct IntervalTimeline {
+    ArenaVector<std::pair<int, int>> availableIntervals;
+
+    explicit IntervalTimeline(Arena &arena) : availableIntervals({{0, std::numeric_limits<int>::max()}}, arena) {
+    }
+
+    [[nodiscard]] int earliestFit(int minStartTime, int duration) const {
+        for (const auto &[start, end] : availableIntervals) {
+            int startTime = std::max(minStartTime, start);
+            if (startTime > end) {
+                continue;
+            }
+
+            if (startTime + duration <= end) {
+                return startTime;
+            }
+        }
+
+        return -1;
+    }
+
+    void reserve(int startTime, int endTime) {
+        for (std::size_t i = 0; i < availableIntervals.size(); i++) {
+            int start = availableIntervals[i].first;
+            int end = availableIntervals[i].second;
+
+            if (startTime >= start && endTime <= end) {
+                availableIntervals.erase(availableIntervals.begin() + i);
+
+                if (startTime != start) {
+                    availableIntervals.emplace_back(start, startTime);
+                }
+
+                if (endTime != end) {
+                    availableIntervals.emplace_back(endTime, end);
+                }
+
+                break;
+            }
+        }
+
+        std::sort(availableIntervals.begin(),
+                  availableIntervals.end(),
+                  [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+                      return a.first < b.first;
+                  });
+    }
+
+    // Frees a reserved [startTime, endTime] and merges it with the free intervals it touches
+    void release(int startTime, int endTime) {
+        auto next = std::lower_bound(availableIntervals.begin(),
+                                     availableIntervals.end(),
+                                     startTime,
+                                     [](const std::pair<int, int> &interval, int time) {
+                                         return interval.first < time;
+                                     });
+
+        bool mergesPrevious = next != availableIntervals.begin() && std::prev(next)->second == startTime;
+        bool mergesNext = next != availableIntervals.end() && next->first == endTime;
+
+        if (mergesPrevious && mergesNext) {
+            std::prev(next)->second = next->second;
+            availableIntervals.erase(next);
+        } else if (mergesPrevious) {
+            std::prev(next)->second = endTime;
+        } else if (mergesNext) {
+            next->first = startTime;
+        } else {
+            availableIntervals.emplace(next, startTime, endTime);
+        }
+    }
+
+    void clear() {
+        availableIntervals.assign({{0, std::numeric_limits<int>::max()}});
+    }
+};
+
+// Free time of a machine as an occupancy bitmap with one bit per time unit, set while the machine is free.
+// A segment tree over the 64-unit words keeps the longest free prefix, suffix and run of every range of words,
+// so an earliest-fit query skips every range too fragmented to hold the reservation and only descends towards the answer.
+// Time beyond the bitmap is free, the bitmap doubles whenever a reservation reaches past its end.
+struct BitmapTimeline {
+    struct Runs {
+        std::uint32_t prefix = 0;
+        std::uint32_t suffix = 0;
+        std::uint32_t longest = 0;
+    };
+
+    ArenaVector<std::uint64_t> words;
+    ArenaVector<Runs> tree;
+
+    explicit BitmapTimeline(Arena &arena, std::size_t noWords = 64) : words(arena), tree(arena) {
+        resize(std::bit_ceil(std::max<std::size_t>(noWords, 1)));
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return words.size() * 64;
+    }
+
+    [[nodiscard]] int earliestFit(int minStartTime, int duration) const {
+        if (duration <= 0) {
+            // Free intervals are closed, so an empty reservation also fits right at the end of a free run
+            int startTime = minStartTime;
+            while (!isFree(startTime) && (startTime == 0 || !isFree(startTime - 1))) {
+                startTime++;
+            }
+
+            return startTime;
+        }
+
+        std::size_t run = 0;
+        std::size_t startTime = findFit(1, 0, size(), minStartTime, duration, run);
+        if (startTime != std::numeric_limits<std::size_t>::max()) {
+            return (int) startTime;
+        }
+
+        return (int) std::max<std::size_t>(minStartTime, size() - run);
+    }
+
+    void reserve(int startTime, int endTime) {
+        if (endTime <= startTime) {
+            return;
+        }
+
+        if ((std::size_t) endTime > size()) {
+            std::size_t noWords = words.size();
+            while (noWords * 64 < (std::size_t) endTime) {
+                noWords *= 2;
+            }
+
+            resize(noWords);
+        }
+
+        for (std::size_t word = startTime / 64; word * 64 < (std::size_t) endTime; word++) {
+            words[word] &= ~maskOf(word, startTime, endTime);
+            update(word);
+        }
+    }
+
+    // Frees a reserved [startTime, endTime), which lies within the bitmap as it was reserved
+    void release(int startTime, int endTime) {
+        for (std::size_t word = startTime / 64; word * 64 < (std::size_t) endTime; word++) {
+            words[word] |= maskOf(word, startTime, endTime);
+            update(word);
+        }
+    }
+
+    void clear() {
+        std::fill(words.begin(), words.end(), ~0ull);
+        build();
+    }
+
+private:
+    [[nodiscard]] bool isFree(std::size_t time) const {
+        return time >= size() || (words[time / 64] >> (time % 64) & 1) != 0;
+    }
+
+    // Bits of the word that lie within [startTime, endTime)
+    static std::uint64_t maskOf(std::size_t word, int startTime, int endTime) {
+        std::uint64_t mask = ~0ull;
+
+        if (word == (std::size_t) startTime / 64) {
+            mask &= ~0ull << (startTime % 64);
+        }
+
+        if (word == (std::size_t) (endTime - 1) / 64 && endTime % 64 != 0) {
+            mask &= ~0ull >> (64 - endTime % 64);
+        }
+
+        return mask;
+    }
+
+    [[nodiscard]] std::uint64_t wordAt(std::size_t word) const {
+        return word < words.size() ? words[word] : ~0ull;
+    }
+
+    static Runs leafRuns(std::uint64_t word) {
+        Runs runs;
+        runs.prefix = std::countr_one(word);
+        runs.suffix = std::countl_one(word);
+
+        while (word != 0) {
+            word &= word >> 1;
+            runs.longest++;
+        }
+
+        return runs;
+    }
+
+    static Runs combine(const Runs &left, const Runs &right, std::uint32_t halfLength) {
+        Runs runs;
+        runs.prefix = left.prefix == halfLength ? halfLength + right.prefix : left.prefix;
+        runs.suffix = right.suffix == halfLength ? halfLength + left.suffix : right.suffix;
+        runs.longest = std::max({left.longest, right.longest, left.suffix + right.prefix});
+
+        return runs;
+    }
+
+    void resize(std::size_t noWords) {
+        words.resize(noWords, ~0ull);
+        tree.assign(2 * noWords, Runs());
+        build();
+    }
+
+    void build() {
+        std::size_t noWords = words.size();
+        for (std::size_t i = 0; i < noWords; i++) {
+            tree[noWords + i] = leafRuns(words[i]);
+        }
+
+        std::uint32_t halfLength = 64;
+        for (std::size_t level = noWords / 2; level >= 1; level /= 2, halfLength *= 2) {
+            for (std::size_t node = level; node < 2 * level; node++) {
+                tree[node] = combine(tree[2 * node], tree[2 * node + 1], halfLength);
+            }
+        }
+    }
+
+    void update(std::size_t word) {
+        std::size_t node = words.size() + word;
+        tree[node] = leafRuns(words[word]);
+
+        std::uint32_t halfLength = 64;
+        for (node /= 2; node >= 1; node /= 2, halfLength *= 2) {
+            tree[node] = combine(tree[2 * node], tree[2 * node + 1], halfLength);
+        }
+    }
+
+    // Leftmost start at or after minStartTime of a free run of the given duration within the node's range.
+    // run carries the length of the free run at or after minStartTime that ends right where the node starts.
+    std::size_t findFit(std::size_t node,
+                        std::size_t start,
+                        std::size_t length,
+                        std::size_t minStartTime,
+                        std::size_t duration,
+                        std::size_t &run) const {
+        constexpr std::size_t notFound = std::numeric_limits<std::size_t>::max();
+
+        if (start + length <= minStartTime) {
+            return notFound;
+        }
+
+        if (start >= minStartTime) {
+            const Runs &runs = tree[node];
+
+            if (run + runs.prefix >= duration) {
+                return start - run;
+            }
+
+            if (runs.longest < duration) {
+                run = runs.prefix == length ? run + length : runs.suffix;
+                return notFound;
+            }
+        }
+
+        if (length == 64) {
+            std::size_t word = start / 64;
+            std::uint64_t current = words[word];
+
+            if (minStartTime > start) {
+                current &= ~0ull << (minStartTime - start);
+            }
+
+            if (run + std::countr_one(current) >= duration) {
+                return start - run;
+            }
+
+            if (duration <= 64) {
+                // Bit i of fits is set if bits i to i + duration - 1 of the two-word window are all free
+                unsigned __int128 fits = current | (unsigned __int128) wordAt(word + 1) << 64;
+
+                std::size_t shift = 1;
+                while (shift * 2 <= duration) {
+                    fits &= fits >> shift;
+                    shift *= 2;
+                }
+
+                fits &= fits >> (duration - shift);
+
+                if ((std::uint64_t) fits != 0) {
+                    return start + std::countr_zero((std::uint64_t) fits);
+                }
+            }
+
+            run = current == ~0ull ? run + 64 : std::countl_one(current);
+            return notFound;
+        }
+
+        std::size_t result = findFit(2 * node, start, length / 2, minStartTime, duration, run);
+        if (result != notFound) {
+            return result;
+        }
+
+        return findFit(2 * node + 1, start + length / 2, length / 2, minStartTime, duration, run);
+    }
+};
+
+struct Timeline {
+    TimelineEngine engine;
+
+    IntervalTimeline intervals;
+    BitmapTimeline bitmap;
+
+    // End of the latest reservation, the machine is free from then on
+    int freeFrom = 0;
+
+    // At least as long as every free interval before freeFrom, or 0 if there is none. Releasing a reservation leaves
+    // no such bound and sets it to the maximum.
+    int longestGap = 0;
+
+    Timeline(Arena &arena, TimelineEngine engine)
+        : engine(engine), intervals(arena), bitmap(arena, engine == TimelineEngine::Bitmap ? 256 : 1) {
+    }
+
+    // Earliest start time at or after minStartTime at which the machine is free for duration time units
+    [[nodiscard]] int earliestFit(int minStartTime, int duration) const {
+        if (engine == TimelineEngine::Bitmap) {
+            return bitmap.earliestFit(minStartTime, duration);
+        }
+
+        return intervals.earliestFit(minStartTime, duration);
+    }
+
+    // Whether earliestFit(minStartTime, duration) is the later of minStartTime and freeFrom for every minStartTime
+    [[nodiscard]] bool fitsOnlyAtEnd(int duration) const {
+        return longestGap == 0 || duration > longestGap;
+    }
+
+    void reserve(int startTime, int endTime) {
+        // An empty reservation splits a free interval but leaves the bitmap as it is
+        if (endTime > startTime || engine == TimelineEngine::Intervals) {
+            if (startTime > freeFrom) {
+                longestGap = std::max(longestGap, startTime - freeFrom);
+            }
+
+            freeFrom = std::max(freeFrom, endTime);
+        }
+
+        if (engine == TimelineEngine::Bitmap) {
+            bitmap.reserve(startTime, endTime);
+        } else {
+            intervals.reserve(startTime, endTime);
+        }
+    }
+
+    void release(int startTime, int endTime) {
+        longestGap = std::numeric_limits<int>::max();
+
+        if (engine == TimelineEngine::Bitmap) {
+            bitmap.release(startTime, endTime);
+        } else {
+            intervals.release(startTime, endTime);
+        }
+    }
+
+    void clear() {
+        freeFrom = 0;
+        longestGap = 0;
+
+        if (engine == TimelineEngine::Bitmap) {
+            bitmap.clear();
+        } else {
+            intervals.clear();
+        }
+    }
+};
@@ -0,0 +1,2695 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <set>
+#include <sstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "anytime.h"
+#include "arena.h"
+#include "arguments.h"
+#include "bitset.h"
+#include "bounds.h"
+#include "components.h"
+#include "features.h"
+#include "incumbent.h"
+#include "instance.h"
+#include "justification.h"
+#include "list.h"
+#include "parallel.h"
+#include "reduction.h"
+#include "selector.h"
+#include "server.h"
+#include "timeline.h"
+
+#ifdef LOCAL
+#define log if (true) std::cerr
+#else
+#define log if (false) std::cerr
+#endif
+
+struct Machine {
+    int id = 0;
+    int index = 0;
+    int power = 0;
+
+    Timeline timeline;
+
+    Machine(Arena &arena, TimelineEngine engine) : timeline(arena, engine) {
+    }
+};
+
+// Machines of one power, on which a task takes equally long. They are ordered by the time they are free from, and the
+// ones with free intervals before that also by the bound on the longest of them, so a query only needs an earliest fit
+// on machines whose free intervals may hold the task.
+struct MachineClass {
+    int power = 0;
+    BitSet members;
+
+    std::set<std::pair<int, int>> byFreeFrom;
+    std::set<std::pair<int, int>> byLongestGap;
+
+    MachineClass(Arena &arena, int noMachines, int power) : power(power), members(arena, noMachines) {
+    }
+
+    void insert(const Machine &machine) {
+        byFreeFrom.emplace(machine.timeline.freeFrom, machine.index);
+        if (machine.timeline.longestGap > 0) {
+            byLongestGap.emplace(machine.timeline.longestGap, machine.index);
+        }
+    }
+
+    void erase(const Machine &machine) {
+        byFreeFrom.erase({machine.timeline.freeFrom, machine.index});
+        byLongestGap.erase({machine.timeline.longestGap, machine.index});
+    }
+};
+
+struct Disk {
+    int id = 0;
+    int speed = 0;
+    int capacity = 0;
+
+    int usedCapacity = 0;
+};
+
+struct Task {
+    int id = 0;
+    int index = 0;
+
+    int taskSize = 0;
+    int dataSize = 0;
+
+    BitSet affinities;
+
+    ArenaVector<Task *> dataDependencies;
+    ArenaVector<Task *> dataDependents;
+
+    ArenaVector<Task *> taskDependencies;
+    ArenaVector<Task *> taskDependents;
+
+    int startTime = 0;
+    Machine *machine = nullptr;
+    Disk *disk = nullptr;
+
+    ArenaSet<Task *> dependencies;
+    ArenaSet<Task *> dependents;
+
+    double priority = -1;
+    std::size_t diskActivity = 0;
+
+    explicit Task(Arena &arena)
+        : dataDependencies(arena),
+          dataDependents(arena),
+          taskDependencies(arena),
+          taskDependents(arena),
+          dependencies(arena),
+          dependents(arena) {
+    }
+
+    [[nodiscard]] bool hasUnscheduledDependencies() const {
+        return std::any_of(dependencies.begin(), dependencies.end(), [](const Task *task) {
+            return task->machine == nullptr;
+        });
+    }
+
+    [[nodiscard]] bool hasUnprioritizedDependents() const {
+        return std::any_of(dependents.begin(), dependents.end(), [](const Task *task) {
+            return task->priority == -1;
+        });
+    }
+};
+
+// Scheduling state of all tasks as columns indexed by task index, with the dependencies of each task in CSR form.
+// Keeps the dependency loops in findScheduleOption on contiguous memory instead of chasing Task pointers.
+struct TaskColumns {
+    ArenaVector<int> writeTime;
+    ArenaVector<int> readTime;
+
+    ArenaVector<int> endRunTime;
+    ArenaVector<int> endWriteTime;
+
+    ArenaVector<int> dataDependencyOffsets;
+    ArenaVector<int> dataDependencies;
+
+    ArenaVector<int> taskDependencyOffsets;
+    ArenaVector<int> taskDependencies;
+
+    explicit TaskColumns(Arena &arena)
+        : writeTime(arena),
+          readTime(arena),
+          endRunTime(arena),
+          endWriteTime(arena),
+          dataDependencyOffsets(arena),
+          dataDependencies(arena),
+          taskDependencyOffsets(arena),
+          taskDependencies(arena) {
+    }
+};
+
+struct ScheduleOption {
+    Task *task = nullptr;
+    Machine *machine = nullptr;
+    int startTime = 0;
+    int endTime = 0;
+};
+
+// Machine and start time a task had in an earlier schedule, machine is -1 if it has none
+struct PlacementHint {
+    int machine = -1;
+    int startTime = 0;
+};
+
+// Placement of a task read from a schedule file as indices, -1 for a task, machine or disk the file does not name
+struct PreviousPlacement {
+    int startTime = -1;
+    int machine = -1;
+    int disk = -1;
+};
+
+// Private copy of a schedule that a large-neighbourhood search worker destroys and repairs.
+// Every machine keeps the list of its tasks and a timeline in sync with them. A repair releases and reserves the time
+// of the tasks it moves, which only touches the timelines of the machines they move between.
+struct WorkingSchedule {
+    Arena arena;
+
+    std::vector<int> startTime;
+    std::vector<int> machineOf;
+    std::vector<int> endRunTime;
+    std::vector<int> endWriteTime;
+
+    std::vector<Timeline> timelines;
+    std::vector<std::vector<int>> machineTasks;
+    std::vector<int> positionOnMachine;
+
+    int makespan = 0;
+    long long totalEndTime = 0;
+
+    std::mt19937 random;
+
+    std::size_t noRepairs = 0;
+    std::size_t noAccepted = 0;
+
+    WorkingSchedule(int noTasks, int noMachines, TimelineEngine engine, unsigned seed)
+        : startTime(noTasks),
+          machineOf(noTasks),
+          endRunTime(noTasks),
+          endWriteTime(noTasks),
+          machineTasks(noMachines),
+          positionOnMachine(noTasks),
+          random(seed) {
+        for (int i = 0; i < noMachines; i++) {
+            timelines.emplace_back(arena, engine);
+        }
+    }
+
+    // Lexicographically by makespan, then by the total end time, which rewards moving tasks earlier
+    [[nodiscard]] bool isBetterThan(const WorkingSchedule &other) const {
+        return makespan != other.makespan ? makespan < other.makespan : totalEndTime < other.totalEndTime;
+    }
+
+    void copyFrom(const WorkingSchedule &other) {
+        startTime = other.startTime;
+        machineOf = other.machineOf;
+        endRunTime = other.endRunTime;
+        endWriteTime = other.endWriteTime;
+
+        machineTasks = other.machineTasks;
+        positionOnMachine = other.positionOnMachine;
+
+        makespan = other.makespan;
+        totalEndTime = other.totalEndTime;
+
+        for (int machine = 0; machine < (int) timelines.size(); machine++) {
+            rebuild(machine);
+        }
+    }
+
+    // Recomputes the makespan and total end time and rebuilds every machine's task list and timeline
+    void setUp() {
+        makespan = 0;
+        totalEndTime = 0;
+
+        for (auto &tasks : machineTasks) {
+            tasks.clear();
+        }
+
+        for (int task = 0; task < (int) startTime.size(); task++) {
+            makespan = std::max(makespan, endWriteTime[task]);
+            totalEndTime += endWriteTime[task];
+
+            positionOnMachine[task] = (int) machineTasks[machineOf[task]].size();
+            machineTasks[machineOf[task]].push_back(task);
+        }
+
+        for (int machine = 0; machine < (int) timelines.size(); machine++) {
+            rebuild(machine);
+        }
+    }
+
+    // Puts a task on its machine, reserving its time on the machine's timeline
+    void add(int task) {
+        auto &tasks = machineTasks[machineOf[task]];
+
+        positionOnMachine[task] = (int) tasks.size();
+        tasks.push_back(task);
+
+        timelines[machineOf[task]].reserve(startTime[task], endWriteTime[task]);
+    }
+
+    // Takes a task off its machine, releasing its time on the machine's timeline
+    void remove(int task) {
+        auto &tasks = machineTasks[machineOf[task]];
+
+        int last = tasks.back();
+        tasks[positionOnMachine[task]] = last;
+        positionOnMachine[last] = positionOnMachine[task];
+        positionOnMachine[task] = -1;
+        tasks.pop_back();
+
+        timelines[machineOf[task]].release(startTime[task], endWriteTime[task]);
+    }
+
+    void rebuild(int machine) {
+        Timeline &timeline = timelines[machine];
+        timeline.clear();
+
+        for (int task : machineTasks[machine]) {
+            timeline.reserve(startTime[task], endWriteTime[task]);
+        }
+    }
+};
+
+// Buffers of one thread that decodes priority vectors into schedules. They keep their size between decodes,
+// so decoding only allocates while they first grow.
+struct PriorityDecoder {
+    Arena arena;
+    std::vector<Timeline> timelines;
+
+    std::vector<int> startTime;
+    std::vector<int> machineOf;
+    std::vector<int> endRunTime;
+    std::vector<int> endWriteTime;
+
+    std::vector<int> diskOf;
+    std::vector<int> writeTime;
+    std::vector<int> readTime;
+    std::vector<int> usedCapacity;
+
+    std::vector<int> remainingDependencies;
+    std::vector<int> order;
+
+    int makespan = 0;
+    long long totalEndTime = 0;
+
+    PriorityDecoder(int noMachines, TimelineEngine engine) {
+        for (int i = 0; i < noMachines; i++) {
+            timelines.emplace_back(arena, engine);
+        }
+    }
+
+    // Lexicographically by makespan, then by the total end time
+    [[nodiscard]] std::pair<int, long long> fitness() const {
+        return {makespan, totalEndTime};
+    }
+};
+
+// Settings from the command line, shared by the solvers of all instances a process schedules
+struct SolverOptions {
+    TimelineEngine timelineEngine = TimelineEngine::Intervals;
+    bool reduceDependencies = false;
+    bool levelPriorities = true;
+    bool minMinSelection = false;
+    double urgencyWeight = 0;
+    int speculationDepth = 1;
+    bool machineClasses = false;
+    int justificationIterations = 0;
+    int evolutionTimeLimit = 0;
+    int searchTimeLimit = 0;
+    double optimalityGap = 0;
+    std::string warmStartPath;
+
+    // Repair mode reads the schedule at repairPath and moves only what the removed machines and disks invalidate
+    std::string repairPath;
+    std::vector<int> removedMachineIds;
+    std::vector<int> removedDiskIds;
+
+    // Anytime mode publishes every improved complete schedule and writes out the last one on a signal.
+    // Improvement searches never run past searchDeadline.
+    bool anytime = false;
+    std::chrono::steady_clock::time_point searchDeadline = std::chrono::steady_clock::time_point::max();
+
+    ThreadPool *threadPool = nullptr;
+
+    // In a portfolio, construction gives up as soon as the schedule must end later than the incumbent
+    const Incumbent *incumbent = nullptr;
+
+    // Whether anything runs after construction that can still improve the schedule
+    [[nodiscard]] bool hasImprovementPhase() const {
+        return !warmStartPath.empty() || evolutionTimeLimit > 0 || searchTimeLimit > 0 || justificationIterations > 0;
+    }
+};
+
+// Schedules a single instance, everything it allocates lives in the arena it is given
+struct Solver : SolverOptions {
+    Arena &arena;
+
+    // Improvement searches stop once the makespan is at most this, the lower bound widened by optimalityGap percent
+    int targetMakespan = 0;
+
+    int publishedMakespan = std::numeric_limits<int>::max();
+
+    // Set when construction gave up on the incumbent, the schedule is then incomplete and not written
+    bool cancelled = false;
+
+    // Set when the warm-started schedule replaced the list schedule
+    bool warmStarted = false;
+
+    ArenaVector<Task> tasks{arena};
+    ArenaVector<Machine> machines{arena};
+    ArenaVector<Disk> disks{arena};
+
+    // Machine classes by decreasing power and the class of every machine, only kept up to date while scheduling
+    // machines with machineClasses set and empty otherwise
+    std::vector<MachineClass> classes;
+    ArenaVector<int> classOf{arena};
+
+    TaskColumns columns{arena};
+
+    Components components;
+    ComponentShapes shapes;
+
+    // The instance being scheduled, whose affinity lists give the order in which equal machines tie
+    const Instance *loadedInstance = nullptr;
+
+    Solver(Arena &arena, const SolverOptions &options) : SolverOptions(options), arena(arena) {
+    }
+
+    Solver(const Solver &) = delete;
+    Solver &operator=(const Solver &) = delete;
+
+    void run(const Instance &instance, std::ostream &out) {
+        loadedInstance = &instance;
+        arena.reserve(estimateArenaSize(instance));
+
+        tasks.reserve(instance.noTasks());
+        machines.reserve(instance.noMachines());
+        disks.resize(instance.noDisks());
+
+        timePhase("findComponents", [&]() { components = Components(instance); });
+        timePhase("findShapes", [&]() { shapes = ComponentShapes(instance, components, *threadPool); });
+        log << "Found " << components.size() << " component(s) of " << shapes.size() << " shape(s)" << std::endl;
+
+        for (int i = 0; i < instance.noMachines(); i++) {
+            Machine &machine = machines.emplace_back(arena, timelineEngine);
+            machine.id = instance.machines[i].id;
+            machine.index = i;
+            machine.power = instance.machines[i].power;
+        }
+
+        for (int i = 0; i < instance.noDisks(); i++) {
+            disks[i].id = instance.disks[i].id;
+            disks[i].speed = instance.disks[i].speed;
+            disks[i].capacity = instance.disks[i].capacity;
+        }
+
+        for (int i = 0; i < instance.noTasks(); i++) {
+            tasks.emplace_back(arena);
+        }
+
+        for (int i = 0; i < instance.noTasks(); i++) {
+            Task &task = tasks[i];
+            task.id = instance.tasks[i].id;
+            task.index = i;
+            task.taskSize = instance.tasks[i].taskSize;
+            task.dataSize = instance.tasks[i].dataSize;
+
+            task.affinities = BitSet(arena, instance.noMachines());
+            for (int machine : instance.affinitiesOf(i)) {
+                task.affinities.insert(machine);
+            }
+
+            link(task.dataDependencies, instance.dataDependenciesOf(i), tasks);
+            link(task.dataDependents, instance.dataDependentsOf(i), tasks);
+
+            if (!reduceDependencies) {
+                link(task.taskDependencies, instance.taskDependenciesOf(i), tasks);
+                link(task.taskDependents, instance.taskDependentsOf(i), tasks);
+            }
+        }
+
+        if (reduceDependencies) {
+            timePhase("linkReducedTaskDependencies", [&]() { linkReducedTaskDependencies(instance); });
+        }
+
+        if (evolutionTimeLimit > 0 || searchTimeLimit > 0 || justificationIterations > 0) {
+            LowerBounds bounds;
+            timePhase("computeLowerBounds", [&]() { bounds = LowerBounds(instance); });
+
+            targetMakespan = (int) std::floor(bounds.value() * (1 + optimalityGap / 100));
+            log << "Lower bound " << bounds.value() << " (critical path " << bounds.criticalPath
+                << ", affinity load " << bounds.affinityLoad << ", disk traffic " << bounds.diskTraffic
+                << "), target makespan " << targetMakespan << std::endl;
+        }
+
+        if (repairPath.empty()) {
+            scheduleTasks();
+        } else {
+            repairTasks();
+        }
+
+        if (cancelled) {
+            return;
+        }
+
+        if (anytime) {
+            publishTasks();
+            AnytimeOutput::finish();
+            return;
+        }
+
+        for (const auto &task : tasks) {
+            out << task.id
+                << " " << task.startTime
+                << " " << task.machine->id
+                << " " << task.disk->id
+                << "\n";
+        }
+    }
+
+    void scheduleTasks() {
+        timePhase("setDependenciesDependents", [&]() { setDependenciesDependents(); });
+        timePhase("setPriorities", [&]() { setPriorities(); });
+        timePhase("estimateDiskDemand", [&]() { estimateDiskDemand(); });
+        timePhase("scheduleDisks", [&]() { scheduleDisks(); });
+        timePhase("setColumns", [&]() { setColumns(); });
+
+        timePhase("scheduleMachines", [&]() { scheduleMachines(); });
+
+        if (cancelled) {
+            return;
+        }
+
+        if (!warmStartPath.empty()) {
+            timePhase("warmStart", [&]() { warmStart(); });
+        }
+
+        publishTasks();
+
+        if (evolutionTimeLimit > 0 && !isCloseToOptimal(currentMakespan())) {
+            timePhase("evolvePriorities", [&]() { evolvePriorities(); });
+        }
+
+        if (searchTimeLimit > 0 && !isCloseToOptimal(currentMakespan())) {
+            timePhase("searchNeighbourhoods", [&]() { searchNeighbourhoods(); });
+        }
+
+        if (justificationIterations > 0 && !isCloseToOptimal(currentMakespan())
+            && std::chrono::steady_clock::now() < searchDeadline) {
+            timePhase("justify", [&]() { justify(); });
+        }
+
+        const auto &stats = arena.getStats();
+        log << "Arena: " << stats.allocations << " allocations, "
+            << stats.usedBytes << " / " << stats.reservedBytes << " bytes used in "
+            << stats.chunks << " chunk(s)" << std::endl;
+    }
+
+    void repairTasks() {
+        timePhase("setDependenciesDependents", [&]() { setDependenciesDependents(); });
+        timePhase("repairSchedule", [&]() { repairSchedule(); });
+    }
+
+    [[nodiscard]] int currentMakespan() const {
+        int makespan = 0;
+        for (const auto &task : tasks) {
+            makespan = std::max(makespan, columns.endWriteTime[task.index]);
+        }
+
+        return makespan;
+    }
+
+    // Called after every scheduled task during construction, sets cancelled if the schedule must end later than the
+    // incumbent of the portfolio
+    bool isHopeless(const ScheduleOption &option) {
+        int task = option.task->index;
+        cancelled = incumbent != nullptr && incumbent->isBeaten(task, columns.endRunTime[task], columns.endWriteTime[task]);
+
+        return cancelled;
+    }
+
+    [[nodiscard]] bool isCloseToOptimal(int makespan) const {
+        return makespan <= targetMakespan;
+    }
+
+    [[nodiscard]] std::chrono::steady_clock::time_point deadlineAfter(int timeLimit) const {
+        return std::min(searchDeadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(timeLimit));
+    }
+
+    // Publishes a complete schedule in anytime mode unless the last published one had a lower makespan,
+    // fieldsOf(i) returns the id, start time, machine id and disk id of task i
+    template<typename F>
+    void publish(int makespan, F &&fieldsOf) {
+        if (!anytime || makespan > publishedMakespan) {
+            return;
+        }
+
+        publishedMakespan = makespan;
+        AnytimeOutput::publish((int) tasks.size(), std::forward<F>(fieldsOf));
+    }
+
+    void publishTasks() {
+        publish(currentMakespan(), [&](int i) {
+            const Task &task = tasks[i];
+            return std::array{task.id, task.startTime, task.machine->id, task.disk->id};
+        });
+    }
+
+    template<typename F>
+    static void timePhase(const char *name, F &&phase) {
+        auto start = std::chrono::steady_clock::now();
+        phase();
+
+        auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        log << name << ": " << duration.count() << " ms" << std::endl;
+    }
+
+    // Links only the task dependencies that are not implied by other dependencies, which leaves the schedule unchanged
+    // but removes duplicate and transitive edges from every loop over dependencies and dependents.
+    // Data dependencies are always kept as they carry read time.
+    // Which edges are implied by a longer path only depends on the shape of the component, so reachability is computed
+    // once per shape and in parallel, duplicates and task dependencies that repeat a data dependency are found per component.
+    void linkReducedTaskDependencies(const Instance &instance) {
+        std::vector<std::uint8_t> needsImplied(shapes.size());
+        for (int component = 0; component < components.size(); component++) {
+            for (int i : components.tasksOf(component)) {
+                if (!instance.taskDependentsOf(i).empty()) {
+                    needsImplied[shapes.shapeOf[component]] = 1;
+                    break;
+                }
+            }
+        }
+
+        threadPool->parallelFor(0, shapes.size(), [&](int shape) {
+            if (needsImplied[shape] && shapes.shapes[shape].isAcyclic()) {
+                shapes.shapes[shape].setImplied();
+            }
+        }, 1);
+
+        std::vector<std::uint8_t> redundant(instance.header->noTaskDependencies);
+        std::vector<int> dataStamp(instance.noTasks(), -1);
+        std::vector<int> taskStamp(instance.noTasks(), -1);
+
+        threadPool->parallelFor(0, components.size(), [&](int component) {
+            const Shape &shape = shapes.shapeOfComponent(component);
+            if (shape.implied.empty()) {
+                return;
+            }
+
+            for (int from : components.tasksOf(component)) {
+                for (int to : instance.dataDependentsOf(from)) {
+                    dataStamp[to] = from;
+                }
+
+                int localFrom = components.localIndex[from];
+
+                for (int e = instance.taskDependentOffsets[from]; e < instance.taskDependentOffsets[from + 1]; e++) {
+                    int to = instance.taskDependents[e];
+
+                    redundant[e] = dataStamp[to] == from
+                                   || taskStamp[to] == from
+                                   || shape.implied[shape.edgeIndex(localFrom, components.localIndex[to])];
+
+                    taskStamp[to] = from;
+                }
+            }
+        }, 1);
+
+        std::vector<int> noDependencies(tasks.size());
+        for (int from = 0; from < instance.noTasks(); from++) {
+            for (int j = instance.taskDependentOffsets[from]; j < instance.taskDependentOffsets[from + 1]; j++) {
+                if (!redundant[j]) {
+                    noDependencies[instance.taskDependents[j]]++;
+                    tasks[from].taskDependents.push_back(&tasks[instance.taskDependents[j]]);
+                }
+            }
+        }
+
+        for (auto &task : tasks) {
+            task.taskDependencies.reserve(noDependencies[task.index]);
+        }
+
+        std::size_t noKept = 0;
+        for (auto &task : tasks) {
+            for (auto *t : task.taskDependents) {
+                t->taskDependencies.push_back(&task);
+                noKept++;
+            }
+        }
+
+        std::size_t noEdges = instance.header->noTaskDependencies;
+        log << "Reduced task dependencies from " << noEdges << " to " << noKept << " ("
+            << (noEdges == 0 ? 0.0 : 100.0 * (double) (noEdges - noKept) / (double) noEdges) << "% removed)"
+            << std::endl;
+    }
+
+    template<typename T>
+    static void link(ArenaVector<T *> &pointers, std::span<const std::int32_t> indices, ArenaVector<T> &targets) {
+        pointers.reserve(indices.size());
+        for (int index : indices) {
+            pointers.push_back(&targets[index]);
+        }
+    }
+
+    // Upper estimate of everything the graph structures allocate, so the whole solver fits into a single chunk.
+    // Hash sets are counted at one node and one bucket per element, machine intervals at two per task.
+    static std::size_t estimateArenaSize(const Instance &instance) {
+        std::size_t noTasks = instance.noTasks();
+        std::size_t noEdges = instance.header->noDataDependencies + instance.header->noTaskDependencies;
+
+        std::size_t size = 0;
+        size += noTasks * sizeof(Task);
+        size += instance.noMachines() * (sizeof(Machine) + 64);
+        size += instance.noDisks() * sizeof(Disk);
+        size += instance.noMachines() > BitSet::inlineWords * 64 ? noTasks * (instance.noMachines() / 8 + 16) : 0;
+        size += 4 * noEdges * sizeof(Task *);
+        size += 2 * (noEdges + noTasks) * 4 * sizeof(Task *);
+        size += 4 * noTasks * sizeof(std::pair<int, int>);
+        size += (8 * noTasks + noEdges) * sizeof(int);
+
+        return size + size / 4 + 4096;
+    }
+
+    void setDependenciesDependents() {
+        for (auto &task : tasks) {
+            task.dependencies.reserve(task.dataDependencies.size() + task.taskDependencies.size());
+            task.dependents.reserve(task.dataDependents.size() + task.taskDependents.size());
+
+            task.dependencies.insert(task.dataDependencies.begin(), task.dataDependencies.end());
+            task.dependencies.insert(task.taskDependencies.begin(), task.taskDependencies.end());
+
+            task.dependents.insert(task.dataDependents.begin(), task.dataDependents.end());
+            task.dependents.insert(task.taskDependents.begin(), task.taskDependents.end());
+        }
+    }
+
+    void setPriorities() {
+        if (levelPriorities) {
+            setPrioritiesByLevel();
+        } else {
+            setPrioritiesSerial();
+        }
+    }
+
+    void setPrioritiesSerial() {
+        std::queue<Task *> priorityQueue;
+
+        for (auto &task : tasks) {
+            if (!task.hasUnprioritizedDependents()) {
+                priorityQueue.push(&task);
+            }
+        }
+
+        while (!priorityQueue.empty()) {
+            Task *task = priorityQueue.front();
+
+            double maxDependentPriority = 0;
+            for (auto *t : task->dependents) {
+                maxDependentPriority = std::max(maxDependentPriority, (double) t->dataSize + t->priority);
+            }
+
+            task->priority = (double) task->taskSize + maxDependentPriority;
+
+            for (auto *t : task->dependencies) {
+                if (!t->hasUnprioritizedDependents()) {
+                    priorityQueue.push(t);
+                }
+            }
+
+            priorityQueue.pop();
+        }
+    }
+
+    // Computes the same priorities as setPrioritiesSerial, level by level in reverse topological order.
+    // All tasks of a level only depend on priorities of lower levels and can be computed in parallel.
+    // Components share no edges, so with several of them each component is computed on its own thread instead.
+    // Levels and dependents come from the shape of the component, implied dependencies removed by the reduction never
+    // raise a priority as the path implying them already adds at least as much.
+    void setPrioritiesByLevel() {
+        int noTasks = (int) tasks.size();
+
+        std::vector<double> taskSize(noTasks);
+        std::vector<double> dataSize(noTasks);
+        std::vector<double> priority(noTasks, -1);
+
+        for (const auto &task : tasks) {
+            taskSize[task.index] = task.taskSize;
+            dataSize[task.index] = task.dataSize;
+        }
+
+        auto prioritizeLevel = [&](int component, int level, ThreadPool *pool) {
+            const Shape &shape = shapes.shapeOfComponent(component);
+            const int *componentTasks = components.tasksOf(component).data();
+
+            auto prioritize = [&](int k) {
+                int local = shape.levelTasks[k];
+                int i = componentTasks[local];
+
+                double maxDependentPriority = 0;
+                for (int j = shape.dependentOffsets[local]; j < shape.dependentOffsets[local + 1]; j++) {
+                    int t = componentTasks[shape.dependents[j]];
+                    maxDependentPriority = std::max(maxDependentPriority, dataSize[t] + priority[t]);
+                }
+
+                priority[i] = taskSize[i] + maxDependentPriority;
+            };
+
+            if (pool != nullptr) {
+                pool->parallelFor(shape.levelOffsets[level], shape.levelOffsets[level + 1], prioritize);
+            } else {
+                for (int k = shape.levelOffsets[level]; k < shape.levelOffsets[level + 1]; k++) {
+                    prioritize(k);
+                }
+            }
+        };
+
+        if (components.size() == 1) {
+            for (int l = 0; l < shapes.shapeOfComponent(0).noLevels(); l++) {
+                prioritizeLevel(0, l, threadPool);
+            }
+        } else {
+            threadPool->parallelFor(0, components.size(), [&](int component) {
+                for (int l = 0; l < shapes.shapeOfComponent(component).noLevels(); l++) {
+                    prioritizeLevel(component, l, nullptr);
+                }
+            }, 1);
+        }
+
+        for (auto &task : tasks) {
+            task.priority = priority[task.index];
+        }
+
+        int noLevels = 0;
+        for (const auto &shape : shapes.shapes) {
+            noLevels = std::max(noLevels, shape.noLevels());
+        }
+
+        log << "Computed priorities of " << components.size() << " component(s) over up to " << noLevels
+            << " levels on " << threadPool->size() << " thread(s)" << std::endl;
+    }
+
+    // Disk activity of every task, the data it writes times the number of times it is written and read, which orders
+    // the tasks in scheduleDisks. Computed per component in parallel together with the data each component stores.
+    void estimateDiskDemand() {
+        std::vector<long long> componentDataSize(components.size());
+
+        threadPool->parallelFor(0, components.size(), [&](int component) {
+            long long dataSize = 0;
+
+            for (int i : components.tasksOf(component)) {
+                Task &task = tasks[i];
+                task.diskActivity = task.dataSize * (task.dataDependents.size() + 1);
+                dataSize += task.dataSize;
+            }
+
+            componentDataSize[component] = dataSize;
+        }, 16);
+
+        long long totalCapacity = 0;
+        for (const auto &disk : disks) {
+            totalCapacity += disk.capacity;
+        }
+
+        long long totalDataSize = 0;
+        long long maxDataSize = 0;
+        for (long long dataSize : componentDataSize) {
+            totalDataSize += dataSize;
+            maxDataSize = std::max(maxDataSize, dataSize);
+        }
+
+        log << "Disk demand: " << totalDataSize << " / " << totalCapacity << " capacity, largest component "
+            << maxDataSize << std::endl;
+    }
+
+    void scheduleDisks() {
+        std::vector<Disk *> sortedDisks;
+        for (auto &disk : disks) {
+            sortedDisks.push_back(&disk);
+        }
+
+        std::sort(sortedDisks.begin(), sortedDisks.end(), [](const Disk *a, const Disk *b) {
+            return a->speed > b->speed;
+        });
+
+        std::vector<Task *> sortedTasks;
+        for (auto &task : tasks) {
+            sortedTasks.push_back(&task);
+        }
+
+        std::sort(sortedTasks.begin(), sortedTasks.end(), [](const Task *a, const Task *b) {
+            if (a->diskActivity == b->diskActivity) {
+                return a->priority > b->priority;
+            }
+
+            return a->diskActivity > b->diskActivity;
+        });
+
+        for (auto *task : sortedTasks) {
+            task->disk = *std::find_if(sortedDisks.begin(), sortedDisks.end(), [&](const Disk *d) {
+                return d->usedCapacity + task->dataSize <= d->capacity;
+            });
+
+            task->disk->usedCapacity += task->dataSize;
+        }
+    }
+
+    void setColumns() {
+        std::size_t noTasks = tasks.size();
+
+        columns.writeTime.resize(noTasks);
+        columns.readTime.resize(noTasks);
+        columns.endRunTime.assign(noTasks, 0);
+        columns.endWriteTime.assign(noTasks, 0);
+
+        columns.dataDependencyOffsets.assign(noTasks + 1, 0);
+        columns.taskDependencyOffsets.assign(noTasks + 1, 0);
+
+        for (std::size_t i = 0; i < noTasks; i++) {
+            columns.dataDependencyOffsets[i + 1] = columns.dataDependencyOffsets[i] + (int) tasks[i].dataDependencies.size();
+            columns.taskDependencyOffsets[i + 1] = columns.taskDependencyOffsets[i] + (int) tasks[i].taskDependencies.size();
+        }
+
+        columns.dataDependencies.reserve(columns.dataDependencyOffsets[noTasks]);
+        columns.taskDependencies.reserve(columns.taskDependencyOffsets[noTasks]);
+
+        for (const auto &task : tasks) {
+            columns.writeTime[task.index] = std::ceil((double) task.dataSize / (double) task.disk->speed);
+
+            for (const auto *t : task.dataDependencies) {
+                columns.dataDependencies.push_back(t->index);
+            }
+
+            for (const auto *t : task.taskDependencies) {
+                columns.taskDependencies.push_back(t->index);
+            }
+        }
+
+        // The read time only depends on the disks of the data dependencies, which are fixed from here on
+        for (std::size_t i = 0; i < noTasks; i++) {
+            int readTime = 0;
+            for (int j = columns.dataDependencyOffsets[i]; j < columns.dataDependencyOffsets[i + 1]; j++) {
+                readTime += columns.writeTime[columns.dataDependencies[j]];
+            }
+
+            columns.readTime[i] = readTime;
+        }
+    }
+
+    void scheduleMachines() {
+        if (machineClasses) {
+            buildMachineClasses();
+        }
+
+        if (minMinSelection) {
+            scheduleMachinesMinMin();
+        } else {
+            scheduleMachinesByPriority();
+        }
+
+        // Later phases reserve and release without updating the classes
+        classes.clear();
+    }
+
+    void buildMachineClasses() {
+        classes.clear();
+        classOf.assign(machines.size(), -1);
+
+        std::vector<int> powers;
+        for (const Machine &machine : machines) {
+            powers.push_back(machine.power);
+        }
+
+        std::sort(powers.begin(), powers.end(), std::greater<>());
+        powers.erase(std::unique(powers.begin(), powers.end()), powers.end());
+
+        for (int power : powers) {
+            classes.emplace_back(arena, (int) machines.size(), power);
+        }
+
+        for (const Machine &machine : machines) {
+            int k = (int) (std::lower_bound(powers.begin(), powers.end(), machine.power, std::greater<>())
+                           - powers.begin());
+
+            classOf[machine.index] = k;
+            classes[k].members.insert(machine.index);
+            classes[k].insert(machine);
+        }
+    }
+
+    // Schedules the ready task with the highest priority next. With a speculation depth above one, the options of the
+    // next tasks in line are computed in parallel against the current timelines and then committed in order: a task
+    // that became ready in between and outranks the next one ends the round, and an option on a machine that was taken
+    // earlier in the round is recomputed. Every other option is still the best one as the other machines only got
+    // busier, so the schedule is the same as with one task at a time.
+    void scheduleMachinesByPriority() {
+        // Ties are broken by index so the order does not depend on how the ready tasks were collected
+        auto byPriority = [](const Task *a, const Task *b) {
+            if (a->priority == b->priority) {
+                return a->index < b->index;
+            }
+
+            return a->priority > b->priority;
+        };
+
+        auto byLowerPriority = [&](const Task *a, const Task *b) {
+            return byPriority(b, a);
+        };
+
+        std::priority_queue<Task *, std::vector<Task *>, decltype(byLowerPriority)> tasksToSchedule(byLowerPriority);
+
+        for (auto &task : tasks) {
+            if (!task.hasUnscheduledDependencies()) {
+                tasksToSchedule.push(&task);
+            }
+        }
+
+        std::vector<Task *> batch;
+        std::vector<ScheduleOption> options;
+        std::vector<int> takenInRound(machines.size(), -1);
+
+        int round = 0;
+        std::size_t noSpeculated = 0;
+        std::size_t noRecomputed = 0;
+        std::size_t noReturned = 0;
+
+        while (!tasksToSchedule.empty()) {
+            batch.clear();
+            while ((int) batch.size() < speculationDepth && !tasksToSchedule.empty()) {
+                batch.push_back(tasksToSchedule.top());
+                tasksToSchedule.pop();
+            }
+
+            options.resize(batch.size());
+            threadPool->parallelFor(0, (int) batch.size(), [&](int i) {
+                options[i] = findScheduleOption(batch[i]);
+            }, 1);
+
+            noSpeculated += batch.size() - 1;
+
+            Task *bestNewTask = nullptr;
+
+            for (std::size_t j = 0; j < batch.size(); j++) {
+                Task *task = batch[j];
+
+                if (bestNewTask != nullptr && byPriority(bestNewTask, task)) {
+                    for (std::size_t k = j; k < batch.size(); k++) {
+                        tasksToSchedule.push(batch[k]);
+                    }
+
+                    noReturned += batch.size() - j;
+                    break;
+                }
+
+                if (takenInRound[options[j].machine->index] == round) {
+                    options[j] = findScheduleOption(task);
+                    noRecomputed++;
+                }
+
+                applyScheduleOption(options[j]);
+                takenInRound[options[j].machine->index] = round;
+
+                if (isHopeless(options[j])) {
+                    return;
+                }
+
+                for (auto *t : task->dependents) {
+                    if (!t->hasUnscheduledDependencies()) {
+                        tasksToSchedule.push(t);
+
+                        if (bestNewTask == nullptr || byPriority(t, bestNewTask)) {
+                            bestNewTask = t;
+                        }
+                    }
+                }
+            }
+
+            round++;
+        }
+
+        if (speculationDepth > 1) {
+            log << "Speculated " << noSpeculated << " option(s) in " << round << " rounds, recomputed " << noRecomputed
+                << ", returned " << noReturned << " to the queue" << std::endl;
+        }
+    }
+
+    // Min-min list scheduling: every ready task keeps its best option and the option that ends first is scheduled next,
+    // ties go to the higher priority. A positive urgency weight subtracts that multiple of the priority from the end
+    // time, which favours tasks with much work left after them.
+    // Scheduling a task only makes its machine busier, so a cached option stays the best one of its task unless it is on
+    // that machine, and when it is recomputed it can only end later, so its key can only grow. Options are therefore
+    // only recomputed once they reach the top of the heap while their machine has changed since they were computed.
+    void scheduleMachinesMinMin() {
+        struct Candidate {
+            ScheduleOption option;
+            int machineVersion = 0;
+        };
+
+        auto endsLater = [&](const Candidate &a, const Candidate &b) {
+            double keyA = a.option.endTime - urgencyWeight * a.option.task->priority;
+            double keyB = b.option.endTime - urgencyWeight * b.option.task->priority;
+
+            if (keyA != keyB) {
+                return keyA > keyB;
+            }
+
+            if (a.option.task->priority != b.option.task->priority) {
+                return a.option.task->priority < b.option.task->priority;
+            }
+
+            return a.option.task->index > b.option.task->index;
+        };
+
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(endsLater)> candidates(endsLater);
+        std::vector<int> machineVersions(machines.size());
+
+        auto addCandidate = [&](Task *task) {
+            ScheduleOption option = findScheduleOption(task);
+            candidates.push({option, machineVersions[option.machine->index]});
+        };
+
+        for (auto &task : tasks) {
+            if (!task.hasUnscheduledDependencies()) {
+                addCandidate(&task);
+            }
+        }
+
+        std::size_t noRecomputed = 0;
+
+        while (!candidates.empty()) {
+            Candidate candidate = candidates.top();
+            candidates.pop();
+
+            Task *task = candidate.option.task;
+            Machine *machine = candidate.option.machine;
+
+            if (candidate.machineVersion != machineVersions[machine->index]) {
+                addCandidate(task);
+                noRecomputed++;
+                continue;
+            }
+
+            applyScheduleOption(candidate.option);
+            machineVersions[machine->index]++;
+
+            if (isHopeless(candidate.option)) {
+                return;
+            }
+
+            for (auto *t : task->dependents) {
+                if (!t->hasUnscheduledDependencies()) {
+                    addCandidate(t);
+                }
+            }
+        }
+
+        log << "Min-min recomputed " << noRecomputed << " cached option(s)" << std::endl;
+    }
+
+    // Improves the start times with forward-backward passes, keeping every task on its machine and disk.
+    // Machine timelines are left as they were scheduled.
+    void justify() {
+        int noTasks = (int) tasks.size();
+
+        std::vector<int> duration(noTasks);
+        std::vector<int> machineOf(noTasks);
+        std::vector<int> startTimes(noTasks);
+
+        int makespan = 0;
+        for (const auto &task : tasks) {
+            duration[task.index] = columns.endWriteTime[task.index] - task.startTime;
+            machineOf[task.index] = task.machine->index;
+            startTimes[task.index] = task.startTime;
+
+            makespan = std::max(makespan, columns.endWriteTime[task.index]);
+        }
+
+        CsrGraph dataDependencies{noTasks, columns.dataDependencyOffsets, columns.dataDependencies};
+        CsrGraph taskDependencies{noTasks, columns.taskDependencyOffsets, columns.taskDependencies};
+
+        Justification justification(duration,
+                                    columns.writeTime,
+                                    machineOf,
+                                    (int) machines.size(),
+                                    dataDependencies,
+                                    taskDependencies,
+                                    timelineEngine);
+
+        int justifiedMakespan = justification.run(startTimes, justificationIterations, targetMakespan);
+
+        for (auto &task : tasks) {
+            task.startTime = startTimes[task.index];
+
+            columns.endWriteTime[task.index] = task.startTime + duration[task.index];
+            columns.endRunTime[task.index] = columns.endWriteTime[task.index] - columns.writeTime[task.index];
+        }
+
+        log << "Justified makespan from " << makespan << " to " << justifiedMakespan << std::endl;
+    }
+
+    // Schedules all tasks like scheduleMachinesByPriority, ranking ready tasks by the given priorities instead.
+    // Disks are assigned like scheduleDisks in decreasing order of the disk keys, or kept as they are if there are none.
+    // Returns the makespan, or std::numeric_limits<int>::max() with the worst fitness and nothing placed if the disk
+    // keys leave some data without a disk that has room for it.
+    int decode(PriorityDecoder &decoder, std::span<const double> priorities, std::span<const double> diskKeys) {
+        int noTasks = (int) tasks.size();
+
+        if (diskKeys.empty()) {
+            decoder.diskOf.resize(noTasks);
+            for (const auto &task : tasks) {
+                decoder.diskOf[task.index] = (int) (task.disk - disks.data());
+            }
+
+            decoder.writeTime.assign(columns.writeTime.begin(), columns.writeTime.end());
+            decoder.readTime.assign(columns.readTime.begin(), columns.readTime.end());
+        } else if (!assignDisks(decoder, diskKeys)) {
+            decoder.makespan = std::numeric_limits<int>::max();
+            decoder.totalEndTime = std::numeric_limits<long long>::max();
+            return decoder.makespan;
+        }
+
+        return placeTasks(decoder, priorities);
+    }
+
+    // Places all tasks on the disks the decoder assigned in the order of the given priorities.
+    // A task with a hint stays on the hinted machine if it can start there no later than the hinted start time,
+    // otherwise every machine is scanned.
+    int placeTasks(PriorityDecoder &decoder, std::span<const double> priorities, std::span<const PlacementHint> hints = {}) {
+        int noTasks = (int) tasks.size();
+
+        decoder.startTime.resize(noTasks);
+        decoder.machineOf.resize(noTasks);
+        decoder.endRunTime.assign(noTasks, 0);
+        decoder.endWriteTime.assign(noTasks, 0);
+
+        for (auto &timeline : decoder.timelines) {
+            timeline.clear();
+        }
+
+        decoder.remainingDependencies.resize(noTasks);
+        decoder.order.clear();
+
+        for (const auto &task : tasks) {
+            decoder.remainingDependencies[task.index] = (int) task.dependencies.size();
+            if (task.dependencies.empty()) {
+                decoder.order.push_back(task.index);
+            }
+        }
+
+        // Ties are broken by index like in scheduleMachinesByPriority
+        auto byLowerPriority = [&](int a, int b) {
+            return priorities[a] != priorities[b] ? priorities[a] < priorities[b] : a > b;
+        };
+
+        auto &ready = decoder.order;
+        std::make_heap(ready.begin(), ready.end(), byLowerPriority);
+
+        auto timelineOf = [&](int i) -> const Timeline & { return decoder.timelines[i]; };
+
+        decoder.makespan = 0;
+        decoder.totalEndTime = 0;
+
+        while (!ready.empty()) {
+            std::pop_heap(ready.begin(), ready.end(), byLowerPriority);
+            Task *task = &tasks[ready.back()];
+            ready.pop_back();
+
+            int minStartTime = minStartTimeOf(task->index, decoder.endWriteTime.data(), decoder.endRunTime.data());
+            int readTime = decoder.readTime[task->index];
+            int writeTime = decoder.writeTime[task->index];
+
+            ScheduleOption option;
+            if (!hints.empty() && hints[task->index].machine >= 0) {
+                Machine *machine = &machines[hints[task->index].machine];
+                int duration = readTime + (int) std::ceil((double) task->taskSize / (double) machine->power) + writeTime;
+
+                option.task = task;
+                option.machine = machine;
+                option.startTime = decoder.timelines[machine->index].earliestFit(minStartTime, duration);
+                option.endTime = option.startTime + duration;
+            }
+
+            if (option.machine == nullptr || option.startTime > hints[task->index].startTime) {
+                option = findScheduleOptionByScan(task, minStartTime, readTime, writeTime, timelineOf);
+            }
+
+            decoder.startTime[task->index] = option.startTime;
+            decoder.machineOf[task->index] = option.machine->index;
+            decoder.endWriteTime[task->index] = option.endTime;
+            decoder.endRunTime[task->index] = option.endTime - decoder.writeTime[task->index];
+
+            decoder.timelines[option.machine->index].reserve(option.startTime, option.endTime);
+
+            decoder.makespan = std::max(decoder.makespan, option.endTime);
+            decoder.totalEndTime += option.endTime;
+
+            for (const auto *t : task->dependents) {
+                if (--decoder.remainingDependencies[t->index] == 0) {
+                    ready.push_back(t->index);
+                    std::push_heap(ready.begin(), ready.end(), byLowerPriority);
+                }
+            }
+        }
+
+        return decoder.makespan;
+    }
+
+    // Returns false if some task does not fit on any disk
+    bool assignDisks(PriorityDecoder &decoder, std::span<const double> diskKeys) {
+        int noTasks = (int) tasks.size();
+
+        auto &order = decoder.order;
+        order.resize(noTasks);
+        std::iota(order.begin(), order.end(), 0);
+
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return diskKeys[a] != diskKeys[b] ? diskKeys[a] > diskKeys[b] : a < b;
+        });
+
+        decoder.usedCapacity.assign(disks.size(), 0);
+        decoder.diskOf.resize(noTasks);
+
+        for (int i : order) {
+            int disk = fastestFittingDisk(decoder.usedCapacity, tasks[i].dataSize);
+            if (disk == -1) {
+                return false;
+            }
+
+            decoder.diskOf[i] = disk;
+            decoder.usedCapacity[disk] += tasks[i].dataSize;
+        }
+
+        setTransferTimes(decoder);
+        return true;
+    }
+
+    // Returns -1 if no disk has room for the data
+    [[nodiscard]] int fastestFittingDisk(const std::vector<int> &usedCapacity, int dataSize) const {
+        int disk = -1;
+        for (int d = 0; d < (int) disks.size(); d++) {
+            if (usedCapacity[d] + dataSize > disks[d].capacity) {
+                continue;
+            }
+
+            if (disk == -1 || disks[d].speed > disks[disk].speed) {
+                disk = d;
+            }
+        }
+
+        return disk;
+    }
+
+    void setTransferTimes(PriorityDecoder &decoder) const {
+        int noTasks = (int) tasks.size();
+
+        decoder.writeTime.resize(noTasks);
+        for (int i = 0; i < noTasks; i++) {
+            decoder.writeTime[i] = std::ceil((double) tasks[i].dataSize / (double) disks[decoder.diskOf[i]].speed);
+        }
+
+        decoder.readTime.resize(noTasks);
+        for (int i = 0; i < noTasks; i++) {
+            int readTime = 0;
+            for (int j = columns.dataDependencyOffsets[i]; j < columns.dataDependencyOffsets[i + 1]; j++) {
+                readTime += decoder.writeTime[columns.dataDependencies[j]];
+            }
+
+            decoder.readTime[i] = readTime;
+        }
+    }
+
+    // Starts from a previous schedule in the solver output format, which may be for a slightly changed instance.
+    // Tasks keep their previous disk while it has room and are placed in the order of their previous start times, new
+    // tasks at their start in the list schedule. They keep their previous machine if they may still run on it and
+    // start there no later than before, or in a second repair whenever they may still run on it, the better is taken.
+    // On an unchanged instance this is the order of a feasible schedule, so no task starts later than before.
+    // The result replaces the list schedule unless its makespan is higher, and then seeds evolvePriorities as well.
+    void warmStart() {
+        std::ifstream in(warmStartPath);
+        if (!in) {
+            log << "Cannot open " << warmStartPath << ", starting from the list schedule" << std::endl;
+            return;
+        }
+
+        int noTasks = (int) tasks.size();
+        int noUnknown = 0;
+        std::vector<PreviousPlacement> previous = readSchedule(in, noUnknown);
+
+        std::vector<PlacementHint> hints(noTasks);
+        for (int i = 0; i < noTasks; i++) {
+            if (previous[i].machine >= 0 && tasks[i].affinities.contains(previous[i].machine)) {
+                hints[i] = {previous[i].machine, previous[i].startTime};
+            }
+        }
+
+        PriorityDecoder decoder((int) machines.size(), timelineEngine);
+
+        decoder.usedCapacity.assign(disks.size(), 0);
+        decoder.diskOf.assign(noTasks, -1);
+
+        for (int i = 0; i < noTasks; i++) {
+            int disk = previous[i].disk;
+            if (disk >= 0 && decoder.usedCapacity[disk] + tasks[i].dataSize <= disks[disk].capacity) {
+                decoder.diskOf[i] = disk;
+                decoder.usedCapacity[disk] += tasks[i].dataSize;
+            }
+        }
+
+        for (int i = 0; i < noTasks; i++) {
+            if (decoder.diskOf[i] >= 0) {
+                continue;
+            }
+
+            // The previous disks can leave the remaining data without room where the list schedule had it
+            decoder.diskOf[i] = fastestFittingDisk(decoder.usedCapacity, tasks[i].dataSize);
+            if (decoder.diskOf[i] < 0) {
+                log << "No disk has room for the data of task " << tasks[i].id << " next to the previous disks, "
+                    << "starting from the list schedule" << std::endl;
+                return;
+            }
+
+            decoder.usedCapacity[decoder.diskOf[i]] += tasks[i].dataSize;
+        }
+
+        setTransferTimes(decoder);
+
+        std::vector<double> priorities(noTasks);
+        for (const auto &task : tasks) {
+            int startTime = previous[task.index].startTime;
+            priorities[task.index] = -(startTime >= 0 ? startTime : task.startTime);
+        }
+
+        placeTasks(decoder, priorities, hints);
+
+        // Keeping every task on its machine even if it starts later there can do better when few tasks changed
+        std::vector<PlacementHint> pinnedHints = hints;
+        for (auto &hint : pinnedHints) {
+            hint.startTime = std::numeric_limits<int>::max();
+        }
+
+        PriorityDecoder pinned((int) machines.size(), timelineEngine);
+        pinned.diskOf = decoder.diskOf;
+        pinned.writeTime = decoder.writeTime;
+        pinned.readTime = decoder.readTime;
+
+        placeTasks(pinned, priorities, pinnedHints);
+
+        const PriorityDecoder &result = pinned.fitness() < decoder.fitness() ? pinned : decoder;
+
+        int noKept = 0;
+        for (int i = 0; i < noTasks; i++) {
+            if (result.startTime[i] == previous[i].startTime
+                && result.machineOf[i] == hints[i].machine
+                && result.diskOf[i] == previous[i].disk) {
+                noKept++;
+            }
+        }
+
+        int makespan = currentMakespan();
+
+        log << "Warm start kept " << noKept << " of " << noTasks << " placements, ignored " << noUnknown
+            << " unknown task(s), makespan " << result.makespan << " against " << makespan << " of the list schedule"
+            << std::endl;
+
+        if (result.makespan <= makespan) {
+            applyDecoded(result);
+            warmStarted = true;
+        }
+    }
+
+    // Repairs the schedule at repairPath after the machines and disks with the removed ids dropped out.
+    // Tasks on a removed disk move to the fastest disk with room, which changes their write time and the read time of
+    // their data dependents. These tasks and the ones on a removed machine are affected, every other task keeps its
+    // reservation. Going through the tasks in the order of their old start times, an affected task or one whose
+    // dependencies now end after its start is placed again at its best option, the others stay where they were.
+    void repairSchedule() {
+        std::ifstream in(repairPath);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + repairPath);
+        }
+
+        int noTasks = (int) tasks.size();
+        int noUnknown = 0;
+        std::vector<PreviousPlacement> previous = readSchedule(in, noUnknown);
+
+        for (const auto &task : tasks) {
+            const PreviousPlacement &placement = previous[task.index];
+            if (placement.startTime < 0 || placement.machine < 0 || placement.disk < 0) {
+                throw std::runtime_error("Schedule has no valid placement for task " + std::to_string(task.id));
+            }
+        }
+
+        auto indexOf = [](const auto &resources, int id, const char *kind) {
+            for (int i = 0; i < (int) resources.size(); i++) {
+                if (resources[i].id == id) {
+                    return i;
+                }
+            }
+
+            throw std::runtime_error(std::string("Unknown ") + kind + " " + std::to_string(id));
+        };
+
+        std::vector<bool> removedMachine(machines.size());
+        for (int id : removedMachineIds) {
+            removedMachine[indexOf(machines, id, "machine")] = true;
+        }
+
+        std::vector<bool> removedDisk(disks.size());
+        for (int id : removedDiskIds) {
+            removedDisk[indexOf(disks, id, "disk")] = true;
+        }
+
+        // Makespan of the schedule before the removal, with the old disks
+        int previousMakespan = 0;
+        {
+            std::vector<int> writeTime(noTasks);
+            for (const auto &task : tasks) {
+                writeTime[task.index] = std::ceil((double) task.dataSize / (double) disks[previous[task.index].disk].speed);
+            }
+
+            for (const auto &task : tasks) {
+                int duration = writeTime[task.index]
+                               + (int) std::ceil((double) task.taskSize
+                                                 / (double) machines[previous[task.index].machine].power);
+                for (const auto *t : task.dataDependencies) {
+                    duration += writeTime[t->index];
+                }
+
+                previousMakespan = std::max(previousMakespan, previous[task.index].startTime + duration);
+            }
+        }
+
+        std::vector<char> affected(noTasks, false);
+
+        for (auto &task : tasks) {
+            for (int i = 0; i < (int) machines.size(); i++) {
+                if (removedMachine[i]) {
+                    task.affinities.erase(i);
+                }
+            }
+
+            if (task.affinities.count() == 0) {
+                throw std::runtime_error("Task " + std::to_string(task.id) + " cannot run on any remaining machine");
+            }
+
+            task.startTime = previous[task.index].startTime;
+            task.machine = &machines[previous[task.index].machine];
+            task.disk = &disks[previous[task.index].disk];
+
+            if (removedMachine[task.machine->index]) {
+                affected[task.index] = true;
+            }
+        }
+
+        std::vector<int> usedCapacity(disks.size(), 0);
+        for (int d = 0; d < (int) disks.size(); d++) {
+            if (removedDisk[d]) {
+                disks[d].capacity = 0;
+            }
+        }
+
+        for (const auto &task : tasks) {
+            if (!removedDisk[previous[task.index].disk]) {
+                usedCapacity[previous[task.index].disk] += task.dataSize;
+            }
+        }
+
+        for (auto &task : tasks) {
+            if (!removedDisk[previous[task.index].disk]) {
+                continue;
+            }
+
+            int disk = fastestFittingDisk(usedCapacity, task.dataSize);
+            if (disk == -1) {
+                throw std::runtime_error("No remaining disk has room for the data of task " + std::to_string(task.id));
+            }
+
+            task.disk = &disks[disk];
+            usedCapacity[disk] += task.dataSize;
+
+            affected[task.index] = true;
+            for (const auto *t : task.dataDependents) {
+                affected[t->index] = true;
+            }
+        }
+
+        for (int d = 0; d < (int) disks.size(); d++) {
+            disks[d].usedCapacity = usedCapacity[d];
+        }
+
+        setColumns();
+
+        auto durationOf = [&](const Task &task) {
+            return columns.readTime[task.index]
+                   + (int) std::ceil((double) task.taskSize / (double) task.machine->power)
+                   + columns.writeTime[task.index];
+        };
+
+        for (const auto &task : tasks) {
+            if (!affected[task.index]) {
+                columns.endWriteTime[task.index] = task.startTime + durationOf(task);
+                columns.endRunTime[task.index] = columns.endWriteTime[task.index] - columns.writeTime[task.index];
+                task.machine->timeline.reserve(task.startTime, columns.endWriteTime[task.index]);
+            }
+        }
+
+        // Ready tasks by old start time, which is a topological order as the old schedule respected the dependencies
+        auto byLaterStart = [&](int a, int b) {
+            return previous[a].startTime != previous[b].startTime ? previous[a].startTime > previous[b].startTime : a > b;
+        };
+
+        std::vector<int> remainingDependencies(noTasks);
+        std::vector<int> ready;
+
+        for (const auto &task : tasks) {
+            remainingDependencies[task.index] = (int) task.dependencies.size();
+            if (task.dependencies.empty()) {
+                ready.push_back(task.index);
+            }
+        }
+
+        std::make_heap(ready.begin(), ready.end(), byLaterStart);
+
+        int noAffected = 0;
+        int noInvalidated = 0;
+
+        while (!ready.empty()) {
+            std::pop_heap(ready.begin(), ready.end(), byLaterStart);
+            Task *task = &tasks[ready.back()];
+            ready.pop_back();
+
+            bool invalidated = !affected[task->index]
+                               && minStartTimeOf(task->index, columns.endWriteTime.data(), columns.endRunTime.data())
+                                  > task->startTime;
+
+            if (affected[task->index] || invalidated) {
+                if (invalidated) {
+                    task->machine->timeline.release(task->startTime, columns.endWriteTime[task->index]);
+                    noInvalidated++;
+                } else {
+                    noAffected++;
+                }
+
+                applyScheduleOption(findScheduleOption(task));
+            }
+
+            for (auto *t : task->dependents) {
+                if (--remainingDependencies[t->index] == 0) {
+                    ready.push_back(t->index);
+                    std::push_heap(ready.begin(), ready.end(), byLaterStart);
+                }
+            }
+        }
+
+        log << "Repaired " << noAffected << " affected and " << noInvalidated << " invalidated task(s), kept "
+            << noTasks - noAffected - noInvalidated << ", makespan from " << previousMakespan << " to "
+            << currentMakespan() << std::endl;
+    }
+
+    // Reads a schedule in the solver output format, lines of unknown tasks are counted in noUnknown and skipped
+    std::vector<PreviousPlacement> readSchedule(std::istream &in, int &noUnknown) {
+        std::unordered_map<int, int> taskOfId;
+        std::unordered_map<int, int> machineOfId;
+        std::unordered_map<int, int> diskOfId;
+
+        for (const auto &task : tasks) {
+            taskOfId[task.id] = task.index;
+        }
+
+        for (const auto &machine : machines) {
+            machineOfId[machine.id] = machine.index;
+        }
+
+        for (int d = 0; d < (int) disks.size(); d++) {
+            diskOfId[disks[d].id] = d;
+        }
+
+        std::vector<PreviousPlacement> previous(tasks.size());
+
+        int id, startTime, machineId, diskId;
+        while (in >> id >> startTime >> machineId >> diskId) {
+            auto task = taskOfId.find(id);
+            if (task == taskOfId.end()) {
+                noUnknown++;
+                continue;
+            }
+
+            PreviousPlacement &placement = previous[task->second];
+            placement.startTime = startTime;
+
+            auto machine = machineOfId.find(machineId);
+            if (machine != machineOfId.end()) {
+                placement.machine = machine->second;
+            }
+
+            auto disk = diskOfId.find(diskId);
+            if (disk != diskOfId.end()) {
+                placement.disk = disk->second;
+            }
+        }
+
+        return previous;
+    }
+
+    // Biased random-key genetic algorithm over priority vectors and disk keys for evolutionTimeLimit milliseconds.
+    // The population starts from the heuristic priorities and disk order, the start order of a warm-started schedule and
+    // perturbations of them. Every generation keeps the elite, adds perturbed copies of elite members and fills up with
+    // children that take each key from an elite parent with probability inheritance. Children are bred and decoded in
+    // parallel, one decoder per thread.
+    // The result only replaces the schedule if its makespan is lower.
+    void evolvePriorities() {
+        static constexpr int populationSize = 24;
+        static constexpr int eliteSize = 6;
+        static constexpr int noMutants = 4;
+        static constexpr double inheritance = 0.7;
+        static constexpr double mutationNoise = 0.3;
+
+        auto deadline = deadlineAfter(evolutionTimeLimit);
+
+        int noTasks = (int) tasks.size();
+        int noKeys = 2 * noTasks;
+
+        // Disk keys follow the order in which scheduleDisks assigned the tasks
+        std::vector<int> diskOrder(noTasks);
+        std::iota(diskOrder.begin(), diskOrder.end(), 0);
+        std::sort(diskOrder.begin(), diskOrder.end(), [&](int a, int b) {
+            if (tasks[a].diskActivity != tasks[b].diskActivity) {
+                return tasks[a].diskActivity > tasks[b].diskActivity;
+            }
+
+            return tasks[a].priority != tasks[b].priority ? tasks[a].priority > tasks[b].priority : a < b;
+        });
+
+        std::vector<double> initialKeys(noKeys);
+        for (int i = 0; i < noTasks; i++) {
+            initialKeys[i] = tasks[i].priority;
+            initialKeys[noTasks + diskOrder[i]] = noTasks - i;
+        }
+
+        int noThreads = threadPool->size();
+
+        std::vector<std::unique_ptr<PriorityDecoder>> decoders;
+        std::vector<std::mt19937> randoms;
+        for (int i = 0; i < noThreads; i++) {
+            decoders.push_back(std::make_unique<PriorityDecoder>((int) machines.size(), timelineEngine));
+            randoms.emplace_back(i + 1);
+        }
+
+        using Fitness = std::pair<int, long long>;
+        constexpr Fitness unevaluated = {std::numeric_limits<int>::max(), 0};
+
+        std::vector<std::vector<double>> population(populationSize, initialKeys);
+        std::vector<std::vector<double>> nextPopulation(populationSize, std::vector<double>(noKeys));
+        std::vector<Fitness> fitness(populationSize, unevaluated);
+        std::vector<Fitness> nextFitness(populationSize);
+
+        // After a warm start every other individual starts from its start order instead, earlier starts get higher
+        // priorities so decoding places the tasks in the order of the warm schedule
+        int noSeeds = 1;
+        if (warmStarted) {
+            std::vector<int> startOrder(noTasks);
+            std::iota(startOrder.begin(), startOrder.end(), 0);
+            std::sort(startOrder.begin(), startOrder.end(), [&](int a, int b) {
+                return tasks[a].startTime != tasks[b].startTime ? tasks[a].startTime < tasks[b].startTime : a < b;
+            });
+
+            for (int i = 0; i < populationSize; i += 2) {
+                for (int j = 0; j < noTasks; j++) {
+                    population[i][startOrder[j]] = noTasks - j;
+                }
+            }
+
+            noSeeds = 2;
+        }
+
+        auto perturb = [&](std::vector<double> &keys, std::mt19937 &random) {
+            std::uniform_real_distribution<double> noise(1 - mutationNoise, 1 + mutationNoise);
+            for (double &key : keys) {
+                key *= noise(random);
+            }
+        };
+
+        // Calls body(i, thread) for every i in [begin, end) until the deadline, striped over the threads
+        auto forEachIndividual = [&](int begin, int end, const std::function<void(int, int)> &body) {
+            threadPool->parallelFor(0, noThreads, [&](int thread) {
+                for (int i = begin + thread; i < end && std::chrono::steady_clock::now() < deadline; i += noThreads) {
+                    body(i, thread);
+                }
+            }, 1);
+        };
+
+        auto evaluate = [&](const std::vector<double> &keys, int thread) {
+            PriorityDecoder &decoder = *decoders[thread];
+            std::span<const double> allKeys(keys);
+
+            decode(decoder, allKeys.first(noTasks), allKeys.subspan(noTasks));
+            return decoder.fitness();
+        };
+
+        forEachIndividual(0, populationSize, [&](int i, int thread) {
+            if (i >= noSeeds) {
+                perturb(population[i], randoms[thread]);
+            }
+
+            fitness[i] = evaluate(population[i], thread);
+        });
+
+        std::vector<int> ranking(populationSize);
+        std::size_t noDecodes = populationSize;
+        int noGenerations = 0;
+
+        while (std::chrono::steady_clock::now() < deadline
+               && !isCloseToOptimal(std::min_element(fitness.begin(), fitness.end())->first)) {
+            std::iota(ranking.begin(), ranking.end(), 0);
+            std::stable_sort(ranking.begin(), ranking.end(), [&](int a, int b) { return fitness[a] < fitness[b]; });
+
+            for (int i = 0; i < eliteSize; i++) {
+                nextPopulation[i].swap(population[ranking[i]]);
+                nextFitness[i] = fitness[ranking[i]];
+            }
+
+            std::fill(nextFitness.begin() + eliteSize, nextFitness.end(), unevaluated);
+
+            forEachIndividual(eliteSize, populationSize, [&](int i, int thread) {
+                std::mt19937 &random = randoms[thread];
+                std::vector<double> &child = nextPopulation[i];
+
+                const auto &eliteParent = nextPopulation[random() % eliteSize];
+
+                if (i < eliteSize + noMutants) {
+                    child = eliteParent;
+                    perturb(child, random);
+                } else {
+                    const auto &otherParent = population[ranking[eliteSize + random() % (populationSize - eliteSize)]];
+
+                    std::bernoulli_distribution fromElite(inheritance);
+                    for (int k = 0; k < noKeys; k++) {
+                        child[k] = fromElite(random) ? eliteParent[k] : otherParent[k];
+                    }
+                }
+
+                nextFitness[i] = evaluate(child, thread);
+            });
+
+            population.swap(nextPopulation);
+            fitness.swap(nextFitness);
+
+            noDecodes += populationSize - eliteSize;
+            noGenerations++;
+
+            int leader = (int) (std::min_element(fitness.begin(), fitness.end()) - fitness.begin());
+            if (anytime && fitness[leader].first < publishedMakespan) {
+                PriorityDecoder &decoder = *decoders[0];
+                std::span<const double> leaderKeys(population[leader]);
+                decode(decoder, leaderKeys.first(noTasks), leaderKeys.subspan(noTasks));
+
+                publish(decoder.makespan, [&](int i) {
+                    return std::array{tasks[i].id, decoder.startTime[i], machines[decoder.machineOf[i]].id,
+                                      disks[decoder.diskOf[i]].id};
+                });
+            }
+        }
+
+        int best = (int) (std::min_element(fitness.begin(), fitness.end()) - fitness.begin());
+        int makespan = currentMakespan();
+
+        log << "Evolved makespan from " << makespan << " to " << fitness[best].first << " in " << noGenerations
+            << " generations, " << noDecodes << " decodes" << std::endl;
+
+        if (fitness[best].first >= makespan) {
+            return;
+        }
+
+        PriorityDecoder &decoder = *decoders[0];
+        std::span<const double> bestKeys(population[best]);
+        decode(decoder, bestKeys.first(noTasks), bestKeys.subspan(noTasks));
+
+        applyDecoded(decoder);
+    }
+
+    // Makes the decoded schedule the current one. Machine timelines are left as they were scheduled.
+    void applyDecoded(const PriorityDecoder &decoder) {
+        for (auto &disk : disks) {
+            disk.usedCapacity = 0;
+        }
+
+        for (auto &task : tasks) {
+            task.startTime = decoder.startTime[task.index];
+            task.machine = &machines[decoder.machineOf[task.index]];
+            task.disk = &disks[decoder.diskOf[task.index]];
+            task.disk->usedCapacity += task.dataSize;
+
+            columns.writeTime[task.index] = decoder.writeTime[task.index];
+            columns.readTime[task.index] = decoder.readTime[task.index];
+            columns.endRunTime[task.index] = decoder.endRunTime[task.index];
+            columns.endWriteTime[task.index] = decoder.endWriteTime[task.index];
+        }
+    }
+
+    // Large-neighbourhood search for searchTimeLimit milliseconds. Every thread runs destroy-and-repair steps on its own
+    // copy of the schedule, after each round the threads that fell behind continue from the best copy.
+    // Machine timelines are left as they were scheduled.
+    void searchNeighbourhoods() {
+        static constexpr int repairsPerRound = 16;
+
+        auto deadline = deadlineAfter(searchTimeLimit);
+
+        int noTasks = (int) tasks.size();
+        int noMachines = (int) machines.size();
+
+        std::vector<std::unique_ptr<WorkingSchedule>> schedules;
+        for (int i = 0; i < threadPool->size(); i++) {
+            schedules.push_back(std::make_unique<WorkingSchedule>(noTasks, noMachines, timelineEngine, i + 1));
+        }
+
+        WorkingSchedule &initial = *schedules[0];
+        for (const auto &task : tasks) {
+            initial.startTime[task.index] = task.startTime;
+            initial.machineOf[task.index] = task.machine->index;
+            initial.endRunTime[task.index] = columns.endRunTime[task.index];
+            initial.endWriteTime[task.index] = columns.endWriteTime[task.index];
+        }
+
+        initial.setUp();
+        int initialMakespan = initial.makespan;
+
+        for (std::size_t i = 1; i < schedules.size(); i++) {
+            schedules[i]->copyFrom(initial);
+        }
+
+        int noRounds = 0;
+        int best = 0;
+
+        while (std::chrono::steady_clock::now() < deadline && !isCloseToOptimal(schedules[best]->makespan)) {
+            threadPool->parallelFor(0, (int) schedules.size(), [&](int i) {
+                for (int k = 0; k < repairsPerRound && std::chrono::steady_clock::now() < deadline; k++) {
+                    destroyAndRepair(*schedules[i]);
+                }
+            }, 1);
+
+            for (int i = 0; i < (int) schedules.size(); i++) {
+                if (schedules[i]->isBetterThan(*schedules[best])) {
+                    best = i;
+                }
+            }
+
+            for (int i = 0; i < (int) schedules.size(); i++) {
+                if (schedules[best]->isBetterThan(*schedules[i])) {
+                    schedules[i]->copyFrom(*schedules[best]);
+                }
+            }
+
+            const WorkingSchedule &leader = *schedules[best];
+            if (leader.makespan < publishedMakespan) {
+                publish(leader.makespan, [&](int i) {
+                    return std::array{tasks[i].id, leader.startTime[i], machines[leader.machineOf[i]].id,
+                                      tasks[i].disk->id};
+                });
+            }
+
+            noRounds++;
+        }
+
+        const WorkingSchedule &result = *schedules[best];
+        for (auto &task : tasks) {
+            task.startTime = result.startTime[task.index];
+            task.machine = &machines[result.machineOf[task.index]];
+
+            columns.endRunTime[task.index] = result.endRunTime[task.index];
+            columns.endWriteTime[task.index] = result.endWriteTime[task.index];
+        }
+
+        std::size_t noRepairs = 0;
+        std::size_t noAccepted = 0;
+        for (const auto &schedule : schedules) {
+            noRepairs += schedule->noRepairs;
+            noAccepted += schedule->noAccepted;
+        }
+
+        log << "Neighbourhood search improved makespan from " << initialMakespan << " to " << result.makespan << " in "
+            << noRounds << " rounds, accepted " << noAccepted << " of " << noRepairs << " repairs" << std::endl;
+    }
+
+    // Removes the tasks starting in a random time window, on every machine or on a few of them with a wider window,
+    // and reinserts them one by one at their best option in order of randomly perturbed priorities.
+    // A task has to end before the makespan and before the kept tasks that depend on it start, so every repair is
+    // feasible, it is kept if the schedule did not get worse and undone otherwise.
+    void destroyAndRepair(WorkingSchedule &schedule) {
+        static constexpr int neighbourhoodSize = 24;
+        static constexpr int fewMachines = 2;
+        static constexpr double priorityNoise = 0.25;
+
+        if (schedule.makespan == 0) {
+            return;
+        }
+
+        int noTasks = (int) tasks.size();
+        int noMachines = (int) machines.size();
+
+        std::vector<std::uint8_t> onMachines(noMachines, 1);
+        int noSelectedMachines = noMachines;
+
+        if (noMachines > fewMachines && schedule.random() % 2 == 0) {
+            std::fill(onMachines.begin(), onMachines.end(), 0);
+
+            for (noSelectedMachines = 0; noSelectedMachines < fewMachines;) {
+                int machine = (int) (schedule.random() % noMachines);
+                if (!onMachines[machine]) {
+                    onMachines[machine] = 1;
+                    noSelectedMachines++;
+                }
+            }
+        }
+
+        long long width = (long long) neighbourhoodSize * schedule.makespan * noMachines / ((long long) noSelectedMachines * noTasks);
+        width = std::clamp(width, 1ll, (long long) schedule.makespan);
+
+        int windowStart = (int) (schedule.random() % (schedule.makespan - width + 1));
+        int windowEnd = (int) (windowStart + width);
+
+        std::vector<int> removed;
+        for (int machine = 0; machine < noMachines; machine++) {
+            if (!onMachines[machine]) {
+                continue;
+            }
+
+            for (int task : schedule.machineTasks[machine]) {
+                if (schedule.startTime[task] >= windowStart && schedule.startTime[task] < windowEnd) {
+                    removed.push_back(task);
+                }
+            }
+        }
+
+        if (removed.empty()) {
+            return;
+        }
+
+        schedule.noRepairs++;
+
+        struct Placement {
+            int startTime;
+            int machine;
+            int endRunTime;
+            int endWriteTime;
+        };
+
+        std::vector<Placement> oldPlacements;
+        std::vector<int> positionInRemoved(noTasks, -1);
+        long long removedEndTime = 0;
+
+        for (int k = 0; k < (int) removed.size(); k++) {
+            int task = removed[k];
+
+            positionInRemoved[task] = k;
+            removedEndTime += schedule.endWriteTime[task];
+
+            oldPlacements.push_back({schedule.startTime[task], schedule.machineOf[task],
+                                     schedule.endRunTime[task], schedule.endWriteTime[task]});
+
+            schedule.remove(task);
+        }
+
+        // Latest end times allowed by the kept dependents, and the removed dependencies every task still waits for
+        std::vector<int> deadlines(removed.size(), schedule.makespan);
+        std::vector<int> remainingDependencies(removed.size());
+        std::vector<double> keys(removed.size());
+
+        std::uniform_real_distribution<double> noise(1 - priorityNoise, 1 + priorityNoise);
+
+        for (int k = 0; k < (int) removed.size(); k++) {
+            const Task &task = tasks[removed[k]];
+
+            for (const auto *t : task.dataDependents) {
+                if (positionInRemoved[t->index] == -1) {
+                    deadlines[k] = std::min(deadlines[k], schedule.startTime[t->index]);
+                }
+            }
+
+            for (const auto *t : task.taskDependents) {
+                if (positionInRemoved[t->index] == -1) {
+                    deadlines[k] = std::min(deadlines[k], schedule.startTime[t->index] + columns.writeTime[task.index]);
+                }
+            }
+
+            for (const auto *t : task.dependencies) {
+                if (positionInRemoved[t->index] != -1) {
+                    remainingDependencies[k]++;
+                }
+            }
+
+            keys[k] = task.priority * noise(schedule.random);
+        }
+
+        auto byLowerKey = [&](int a, int b) {
+            return keys[a] != keys[b] ? keys[a] < keys[b] : a > b;
+        };
+
+        std::priority_queue<int, std::vector<int>, decltype(byLowerKey)> ready(byLowerKey);
+        for (int k = 0; k < (int) removed.size(); k++) {
+            if (remainingDependencies[k] == 0) {
+                ready.push(k);
+            }
+        }
+
+        auto timelineOf = [&](int i) -> const Timeline & { return schedule.timelines[i]; };
+
+        int noPlaced = 0;
+        long long placedEndTime = 0;
+        int placedMakespan = 0;
+
+        while (!ready.empty()) {
+            int k = ready.top();
+            ready.pop();
+
+            Task *task = &tasks[removed[k]];
+
+            int minStartTime = minStartTimeOf(task->index, schedule.endWriteTime.data(), schedule.endRunTime.data());
+            ScheduleOption option = findScheduleOptionByScan(task, minStartTime, columns.readTime[task->index],
+                                                             columns.writeTime[task->index], timelineOf);
+
+            if (option.endTime > deadlines[k]) {
+                break;
+            }
+
+            schedule.startTime[task->index] = option.startTime;
+            schedule.machineOf[task->index] = option.machine->index;
+            schedule.endWriteTime[task->index] = option.endTime;
+            schedule.endRunTime[task->index] = option.endTime - columns.writeTime[task->index];
+
+            schedule.add(task->index);
+
+            noPlaced++;
+            placedEndTime += option.endTime;
+            placedMakespan = std::max(placedMakespan, option.endTime);
+
+            for (const auto *t : task->dependents) {
+                int j = positionInRemoved[t->index];
+                if (j != -1 && --remainingDependencies[j] == 0) {
+                    ready.push(j);
+                }
+            }
+        }
+
+        bool complete = noPlaced == (int) removed.size();
+
+        int makespan = schedule.makespan;
+        long long totalEndTime = schedule.totalEndTime - removedEndTime + placedEndTime;
+
+        // The makespan can only have dropped if a removed task ended at it, every placed task ends no later
+        if (complete && std::any_of(oldPlacements.begin(), oldPlacements.end(), [&](const Placement &placement) {
+            return placement.endWriteTime == schedule.makespan;
+        })) {
+            makespan = placedMakespan;
+            for (int task = 0; task < noTasks; task++) {
+                if (positionInRemoved[task] == -1) {
+                    makespan = std::max(makespan, schedule.endWriteTime[task]);
+                }
+            }
+        }
+
+        if (complete && (makespan < schedule.makespan || totalEndTime <= schedule.totalEndTime)) {
+            schedule.makespan = makespan;
+            schedule.totalEndTime = totalEndTime;
+            schedule.noAccepted++;
+            return;
+        }
+
+        // Undo the repair, tasks that were never placed are on no machine
+        for (int task : removed) {
+            if (schedule.positionOnMachine[task] != -1) {
+                schedule.remove(task);
+            }
+        }
+
+        for (int k = 0; k < (int) removed.size(); k++) {
+            int task = removed[k];
+
+            schedule.startTime[task] = oldPlacements[k].startTime;
+            schedule.machineOf[task] = oldPlacements[k].machine;
+            schedule.endRunTime[task] = oldPlacements[k].endRunTime;
+            schedule.endWriteTime[task] = oldPlacements[k].endWriteTime;
+
+            schedule.add(task);
+        }
+    }
+
+    void applyScheduleOption(const ScheduleOption &option) {
+        Task *task = option.task;
+
+        task->startTime = option.startTime;
+        task->machine = option.machine;
+
+        columns.endRunTime[task->index] = option.endTime - columns.writeTime[task->index];
+        columns.endWriteTime[task->index] = option.endTime;
+
+        if (classes.empty()) {
+            option.machine->timeline.reserve(option.startTime, option.endTime);
+            return;
+        }
+
+        MachineClass &machineClass = classes[classOf[option.machine->index]];
+        machineClass.erase(*option.machine);
+        option.machine->timeline.reserve(option.startTime, option.endTime);
+        machineClass.insert(*option.machine);
+    }
+
+    // Earliest start time of a task allowed by the end times of its dependencies
+    int minStartTimeOf(int task, const int *endWriteTime, const int *endRunTime) const {
+        const int *dataDependencies = columns.dataDependencies.data();
+        const int *taskDependencies = columns.taskDependencies.data();
+
+        int minStartTime = 0;
+
+        for (int j = columns.dataDependencyOffsets[task]; j < columns.dataDependencyOffsets[task + 1]; j++) {
+            minStartTime = std::max(minStartTime, endWriteTime[dataDependencies[j]]);
+        }
+
+        for (int j = columns.taskDependencyOffsets[task]; j < columns.taskDependencyOffsets[task + 1]; j++) {
+            minStartTime = std::max(minStartTime, endRunTime[taskDependencies[j]]);
+        }
+
+        return minStartTime;
+    }
+
+    // Earliest end first, then the slowest machine. Options that tie on both are left to the order of the affinities.
+    static bool isBetterOption(const ScheduleOption &option, const Machine *machine, int endTime) {
+        return option.machine == nullptr
+               || endTime < option.endTime
+               || (endTime == option.endTime && machine->power < option.machine->power);
+    }
+
+    // Best option over every machine the task has an affinity for, with the free time of machine i in timelineOf(i).
+    // Machines are visited in the order of the affinities, the bitset only filters out machines that were removed.
+    template<typename F>
+    ScheduleOption findScheduleOptionByScan(Task *task, int minStartTime, int readTime, int writeTime, F &&timelineOf) {
+        ScheduleOption option;
+        option.task = task;
+
+        for (int i : loadedInstance->affinitiesOf(task->index)) {
+            if (!task->affinities.contains(i)) {
+                continue;
+            }
+
+            Machine *machine = &machines[i];
+
+            int runTime = std::ceil((double) task->taskSize / (double) machine->power);
+            int duration = readTime + runTime + writeTime;
+
+            int startTime = timelineOf(i).earliestFit(minStartTime, duration);
+            if (isBetterOption(option, machine, startTime + duration)) {
+                option.machine = machine;
+                option.startTime = startTime;
+                option.endTime = startTime + duration;
+            }
+        }
+
+        return option;
+    }
+
+    ScheduleOption findScheduleOption(Task *task) {
+        int minStartTime = minStartTimeOf(task->index, columns.endWriteTime.data(), columns.endRunTime.data());
+
+        int readTime = columns.readTime[task->index];
+        int writeTime = columns.writeTime[task->index];
+
+        if (!classes.empty()) {
+            return findScheduleOptionByClass(task, minStartTime, readTime, writeTime);
+        }
+
+        auto timelineOf = [&](int i) -> const Timeline & { return machines[i].timeline; };
+        return findScheduleOptionByScan(task, minStartTime, readTime, writeTime, timelineOf);
+    }
+
+    // Same option as findScheduleOptionByScan on the machine timelines. In every class, the machines with a long enough
+    // free interval get an earliest fit, and the others are walked by the time they are free from until the task can
+    // no longer end first on them. Options that tie on end and power go to the machine listed first in the affinities.
+    ScheduleOption findScheduleOptionByClass(Task *task, int minStartTime, int readTime, int writeTime) {
+        ScheduleOption option;
+        option.task = task;
+
+        auto consider = [&](Machine *machine, int startTime, int endTime) {
+            if (isBetterOption(option, machine, endTime)
+                || (endTime == option.endTime && machine->power == option.machine->power
+                    && isListedBefore(task->index, machine->index, option.machine->index))) {
+                option.machine = machine;
+                option.startTime = startTime;
+                option.endTime = endTime;
+            }
+        };
+
+        for (const MachineClass &machineClass : classes) {
+            if (!task->affinities.intersects(machineClass.members)) {
+                continue;
+            }
+
+            int runTime = std::ceil((double) task->taskSize / (double) machineClass.power);
+            int duration = readTime + runTime + writeTime;
+
+            for (auto it = machineClass.byLongestGap.lower_bound({duration, -1}); it != machineClass.byLongestGap.end();
+                 ++it) {
+                int i = it->second;
+                if (task->affinities.contains(i)) {
+                    int startTime = machines[i].timeline.earliestFit(minStartTime, duration);
+                    consider(&machines[i], startTime, startTime + duration);
+                }
+            }
+
+            for (auto [freeFrom, i] : machineClass.byFreeFrom) {
+                int startTime = std::max(minStartTime, freeFrom);
+                if (option.machine != nullptr && startTime + duration > option.endTime) {
+                    break;
+                }
+
+                if (task->affinities.contains(i) && machines[i].timeline.fitsOnlyAtEnd(duration)) {
+                    consider(&machines[i], startTime, startTime + duration);
+                }
+            }
+        }
+
+        return option;
+    }
+
+    // Whether machine a comes before machine b in the affinities of the task
+    bool isListedBefore(int task, int a, int b) const {
+        for (int i : loadedInstance->affinitiesOf(task)) {
+            if (i == a) {
+                return true;
+            }
+
+            if (i == b) {
+                return false;
+            }
+        }
+
+        return false;
+    }
+};
+
+// A strategy of the portfolio writes its schedule and returns its makespan, or returns std::numeric_limits<int>::max()
+// without writing anything if it gave up on beating the incumbent. Without an incumbent it never gives up.
+struct PortfolioStrategy {
+    std::string name;
+    std::function<int(const Instance &, const Incumbent *, ThreadPool &, std::ostream &)> solve;
+};
+
+template<typename PriorityPolicy, typename DiskPolicy, typename PlacementPolicy, typename TieBreakPolicy>
+PortfolioStrategy listStrategy(const std::string &name) {
+    return {name, [](const Instance &instance, const Incumbent *incumbent, ThreadPool &, std::ostream &out) {
+        ListSolver<PriorityPolicy, DiskPolicy, PlacementPolicy, TieBreakPolicy> solver;
+        solver.incumbent = incumbent;
+
+        solver.load(instance);
+        solver.scheduleTasks();
+
+        if (solver.cancelled) {
+            return std::numeric_limits<int>::max();
+        }
+
+        solver.write(out);
+        return solver.makespan();
+    }};
+}
+
+PortfolioStrategy solverStrategy(const std::string &name, const SolverOptions &options) {
+    return {name, [options](const Instance &instance, const Incumbent *incumbent, ThreadPool &threadPool,
+                            std::ostream &out) {
+        Arena arena;
+
+        SolverOptions strategyOptions = options;
+        strategyOptions.threadPool = &threadPool;
+
+        // A schedule that is worse after construction can still win after its improvement phases
+        if (!strategyOptions.hasImprovementPhase()) {
+            strategyOptions.incumbent = incumbent;
+        }
+
+        Solver solver(arena, strategyOptions);
+        solver.run(instance, out);
+
+        return solver.cancelled ? std::numeric_limits<int>::max() : solver.currentMakespan();
+    }};
+}
+
+// v08 in priority order and with min-min selection at three urgency weights, and the list schedulers of v03 to v05.
+// The improvement searches in the options apply to every v08 strategy.
+std::vector<PortfolioStrategy> portfolioStrategies(const SolverOptions &options) {
+    auto withSelection = [&](bool minMinSelection, double urgencyWeight) {
+        SolverOptions strategyOptions = options;
+        strategyOptions.minMinSelection = minMinSelection;
+        strategyOptions.urgencyWeight = urgencyWeight;
+        strategyOptions.speculationDepth = 1;
+
+        return strategyOptions;
+    };
+
+    return {
+            solverStrategy("v08", withSelection(false, 0)),
+            solverStrategy("v08-urgent", withSelection(true, 30)),
+            solverStrategy("v08-urgent-10", withSelection(true, 10)),
+            solverStrategy("v08-urgent-100", withSelection(true, 100)),
+            listStrategy<DownwardRankPriority, DiskActivityDisk, IntervalPlacement, WeakerMachineTieBreak>("v05"),
+            listStrategy<DownwardRankPriority, DiskActivityDisk, IntervalPlacement, EarliestEndTieBreak>("v04"),
+            listStrategy<DownwardRankPriority, DiskActivityDisk, AppendPlacement, EarliestEndTieBreak>("v03"),
+    };
+}
+
+// Runs the portfolio strategies concurrently on the thread pool, each single-threaded, and writes the schedule with the
+// lowest makespan, the earlier strategy winning ties. A strategy without improvement phases gives up as soon as a placed
+// task plus the minimum time still needed after it ends later than the best complete schedule.
+void solvePortfolio(const Instance &instance, const SolverOptions &options, ThreadPool &threadPool, std::ostream &out) {
+    std::vector<PortfolioStrategy> strategies = portfolioStrategies(options);
+    int noStrategies = (int) strategies.size();
+
+    Incumbent incumbent(instance);
+    std::vector<int> makespans(noStrategies);
+    std::vector<std::string> schedules(noStrategies);
+    std::vector<double> durations(noStrategies);
+
+    threadPool.parallelFor(0, noStrategies, [&](int i) {
+        auto start = std::chrono::steady_clock::now();
+
+        ThreadPool strategyThreadPool(1);
+        std::ostringstream schedule;
+        makespans[i] = strategies[i].solve(instance, &incumbent, strategyThreadPool, schedule);
+        schedules[i] = std::move(schedule).str();
+
+        incumbent.offer(makespans[i]);
+        durations[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }, 1);
+
+    int best = 0;
+    for (int i = 0; i < noStrategies; i++) {
+        if (makespans[i] < makespans[best]) {
+            best = i;
+        }
+
+        log << "Strategy " << strategies[i].name << ": ";
+        if (makespans[i] == std::numeric_limits<int>::max()) {
+            log << "gave up";
+        } else {
+            log << "makespan " << makespans[i];
+        }
+        log << " in " << durations[i] << " ms" << std::endl;
+    }
+
+    if (makespans[best] == std::numeric_limits<int>::max()) {
+        throw std::runtime_error("Every strategy of the portfolio gave up");
+    }
+
+    log << "Portfolio picked " << strategies[best].name << std::endl;
+    out << schedules[best];
+}
+
+// An instance is scheduled by the solver with the options, by every strategy of the portfolio, or by the named strategy
+// of the portfolio. Strategy "auto" lets the selector trained by results/train.py pick one from the instance features.
+struct SolveMode {
+    bool portfolio = false;
+    std::string strategy;
+};
+
+void solveInstance(const Instance &instance, const SolverOptions &options, const SolveMode &mode, Arena &arena,
+                   std::ostream &out) {
+    if (mode.portfolio) {
+        solvePortfolio(instance, options, *options.threadPool, out);
+        return;
+    }
+
+    if (mode.strategy.empty()) {
+        Solver solver(arena, options);
+        solver.run(instance, out);
+        return;
+    }
+
+    std::string name = mode.strategy;
+    if (name == "auto") {
+        auto start = std::chrono::steady_clock::now();
+        name = selectStrategy(InstanceFeatures(instance));
+
+        auto selectionTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        log << "Selected strategy " << name << " in " << selectionTime.count() << " ms" << std::endl;
+    }
+
+    std::vector<PortfolioStrategy> strategies = portfolioStrategies(options);
+    auto strategy = std::find_if(strategies.begin(), strategies.end(), [&](const PortfolioStrategy &s) {
+        return s.name == name;
+    });
+
+    if (strategy == strategies.end()) {
+        throw std::runtime_error("Unknown strategy " + name);
+    }
+
+    strategy->solve(instance, nullptr, *options.threadPool, out);
+}
+
+// Searches stop a little before the deadline to leave time for writing the output
+std::chrono::steady_clock::time_point searchDeadlineOf(std::chrono::steady_clock::time_point start, int deadline) {
+    return start + std::chrono::milliseconds(deadline - std::min(100, deadline / 10));
+}
+
+// Schedules the instances of a stream of requests one after another with the thread pool of the options, reusing the
+// arena between them. A request that cannot be loaded or scheduled gets an error reply, the next one is served as usual.
+// A positive deadline in milliseconds applies to every request on its own.
+void serveRequests(RequestStream &stream, SolverOptions options, const SolveMode &mode, Arena &arena, int deadline) {
+    Instance instance;
+    std::string request;
+    std::ostringstream out;
+
+    int noRequests = 0;
+    double totalLatency = 0;
+
+    while (stream.read(request)) {
+        auto start = std::chrono::steady_clock::now();
+        if (deadline > 0) {
+            options.searchDeadline = searchDeadlineOf(start, deadline);
+        }
+
+        out.str({});
+        bool ok = true;
+
+        try {
+            instance.load(request.data(), request.size());
+
+            arena.reset();
+            solveInstance(instance, options, mode, arena, out);
+        } catch (const std::exception &err) {
+            ok = false;
+            out.str(err.what());
+        }
+
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        stream.reply(ok, out.view(), latency.count());
+
+        noRequests++;
+        totalLatency += (double) latency.count() / 1000;
+
+        log << "Request " << noRequests << (ok ? "" : " failed") << " in " << (double) latency.count() / 1000
+            << " ms, arena " << arena.getStats().reservedBytes << " bytes" << std::endl;
+    }
+
+    if (noRequests > 0) {
+        log << "Served " << noRequests << " request(s), mean latency " << totalLatency / noRequests << " ms" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    SolverOptions options;
+    int noThreads = ThreadPool::defaultSize();
+
+    auto start = std::chrono::steady_clock::now();
+    int deadline = 0;
+
+    bool serve = false;
+    std::string socketPath;
+    SolveMode mode;
+    bool features = false;
+
+    bool urgent = false;
+    double urgencyWeight = 30;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            std::string value = arg.substr(arg.find('=') + 1);
+
+            if (arg.starts_with("--timeline=")) {
+                options.timelineEngine = parseTimelineEngine(value);
+            } else if (arg == "--reduce") {
+                options.reduceDependencies = true;
+            } else if (arg == "--priorities=levels" || arg == "--priorities=serial") {
+                options.levelPriorities = value == "levels";
+            } else if (arg == "--selection=priority" || arg == "--selection=minmin" || arg == "--selection=urgent") {
+                options.minMinSelection = value != "priority";
+                urgent = value == "urgent";
+            } else if (arg.starts_with("--urgency=")) {
+                urgencyWeight = parseDouble(arg, value);
+            } else if (arg.starts_with("--speculation=")) {
+                options.speculationDepth = parseInt(arg, value, 1);
+            } else if (arg == "--machines=scan" || arg == "--machines=classes") {
+                options.machineClasses = value == "classes";
+            } else if (arg.starts_with("--justify=")) {
+                options.justificationIterations = parseInt(arg, value, 0);
+            } else if (arg.starts_with("--evolve=")) {
+                options.evolutionTimeLimit = parseInt(arg, value, 0);
+            } else if (arg.starts_with("--lns=")) {
+                options.searchTimeLimit = parseInt(arg, value, 0);
+            } else if (arg.starts_with("--gap=")) {
+                options.optimalityGap = parseDouble(arg, value);
+            } else if (arg.starts_with("--repair=")) {
+                options.repairPath = value;
+            } else if (arg.starts_with("--remove-machine=")) {
+                options.removedMachineIds.push_back(parseInt(arg, value));
+            } else if (arg.starts_with("--remove-disk=")) {
+                options.removedDiskIds.push_back(parseInt(arg, value));
+            } else if (arg.starts_with("--warm=")) {
+                options.warmStartPath = value;
+            } else if (arg == "--anytime") {
+                options.anytime = true;
+            } else if (arg.starts_with("--deadline=")) {
+                options.anytime = true;
+                deadline = parseInt(arg, value, 0);
+            } else if (arg == "--portfolio") {
+                mode.portfolio = true;
+            } else if (arg.starts_with("--strategy=")) {
+                mode.strategy = value;
+            } else if (arg == "--features") {
+                features = true;
+            } else if (arg == "--serve") {
+                serve = true;
+            } else if (arg.starts_with("--socket=")) {
+                socketPath = value;
+            } else if (arg.starts_with("--threads=")) {
+                noThreads = parseInt(arg, value, 1);
+            } else {
+                throw std::invalid_argument("Unknown argument " + arg);
+            }
+        }
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    if (urgent) {
+        options.urgencyWeight = urgencyWeight;
+    }
+
+    // The portfolio picks its schedule once all strategies are done and the list schedulers have no intermediate
+    // schedules, a deadline only caps the searches
+    if (mode.portfolio || !mode.strategy.empty()) {
+        options.anytime = false;
+    }
+
+    if (serve || !socketPath.empty()) {
+        // Every schedule goes into its reply, a deadline only caps the searches of a request
+        options.anytime = false;
+
+        ThreadPool threadPool(noThreads);
+        options.threadPool = &threadPool;
+
+        // A client that goes away makes the reply fail instead of killing the server
+        std::signal(SIGPIPE, SIG_IGN);
+
+        Arena arena;
+
+        try {
+            if (socketPath.empty()) {
+                RequestStream stream(STDIN_FILENO, STDOUT_FILENO);
+                serveRequests(stream, options, mode, arena, deadline);
+            } else {
+                serveUnixSocket(socketPath, [&](int connection) {
+                    RequestStream stream(connection, connection);
+
+                    try {
+                        serveRequests(stream, options, mode, arena, deadline);
+                    } catch (const std::exception &err) {
+                        std::cerr << "Closing connection: " << err.what() << std::endl;
+                    }
+                });
+            }
+        } catch (const std::exception &err) {
+            std::cerr << err.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (deadline > 0) {
+        options.searchDeadline = searchDeadlineOf(start, deadline);
+    }
+
+    if (options.anytime) {
+        AnytimeOutput::blockSignals();
+    }
+
+    ThreadPool threadPool(noThreads);
+    options.threadPool = &threadPool;
+
+    if (options.anytime) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        AnytimeOutput::install(deadline > 0 ? std::max(1, deadline - (int) elapsed.count()) : 0);
+    }
+
+    auto loadStart = std::chrono::steady_clock::now();
+
+    Instance instance;
+
+    try {
+        instance.load(STDIN_FILENO);
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart);
+    log << "Loaded " << (instance.binary ? "binary" : "text") << " instance in " << loadTime.count() << " ms" << std::endl;
+
+    if (features) {
+        auto featuresStart = std::chrono::steady_clock::now();
+        InstanceFeatures instanceFeatures(instance);
+
+        auto featuresTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - featuresStart);
+        log << "Extracted features in " << featuresTime.count() << " ms" << std::endl;
+
+        instanceFeatures.write(std::cout);
+        return 0;
+    }
+
+    try {
+        Arena arena;
+        solveInstance(instance, options, mode, arena, std::cout);
+    } catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}